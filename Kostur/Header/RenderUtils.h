@@ -8,5 +8,13 @@ void drawQuad(float x,float y,float w,float h,
               unsigned int texture,float alpha=1.0f,
               float r=1.0f,float g=1.0f,float b=1.0f);
 
+// Cifre i ikonice displeja u jednom GL_TEXTURE_2D_ARRAY (sloj = indeks putanje);
+// addGlyph skuplja znakove, drawGlyphs ih crta jednim instanciranim pozivom
+unsigned int loadGlyphArray(const char* const* paths,int count,int layerSize);
+void initGlyphs();
+void addGlyph(float x,float y,float w,float h,int layer,
+              float alpha=1.0f,float r=1.0f,float g=1.0f,float b=1.0f);
+void drawGlyphs(unsigned int glyphArray);
+
 extern unsigned int quadVAO;
 extern unsigned int quadVBO;
@@ -11,6 +11,10 @@
 #include "../Header/stb_image.h"
 
 Shader* basicShader = nullptr;
+Shader* glyphShader = nullptr;
+
+// Slojevi niza znakova displeja (cifra d je sloj d)
+enum { GLYPH_MINUS = 10, GLYPH_FIRE, GLYPH_SNOW, GLYPH_OK, GLYPH_COUNT };
 
 float acX = -0.6f;
 float acY = 0.60f;
@@ -93,8 +97,7 @@ static void keyCallback(GLFWwindow* window, int key, int, int action, int)
 }
 
 
-void drawTemperature(float x, float y, float w, float h, int value,
-                     unsigned int digitTex[10], unsigned int minusTex)
+void drawTemperature(float x, float y, float w, float h, int value)
 {
     bool isNegative = value < 0;
     int absValue = std::abs(value);
@@ -112,14 +115,14 @@ void drawTemperature(float x, float y, float w, float h, int value,
     float b = 1.00f;
 
     if(isNegative) {
-        drawQuad(cursorX, y, w, h, minusTex, r, g, b);
+        addGlyph(cursorX, y, w, h, GLYPH_MINUS, r, g, b);
         cursorX += w + spacing;
     }
 
-    drawQuad(cursorX + 0.005f, y, w, h, digitTex[tens], r, g, b);
+    addGlyph(cursorX + 0.005f, y, w, h, tens, r, g, b);
     cursorX += w + spacing;
 
-    drawQuad(cursorX + 0.005f, y, w, h, digitTex[ones], r, g, b);
+    addGlyph(cursorX + 0.005f, y, w, h, ones, r, g, b);
 }
 
 
@@ -152,22 +155,24 @@ int main(){
     Shader shader("shaders/basic.vs","shaders/basic.fs");
     basicShader = &shader;
 
+    Shader glyph("shaders/glyph.vs","shaders/glyph.fs");
+    glyphShader = &glyph;
+
     initQuad();
+    initGlyphs();
     
     unsigned int lampCircleTex = loadTexture("Resources/lamp.png");
 
 
-    unsigned int fireTex = loadTexture("Resources/fire.png");
-    unsigned int snowTex = loadTexture("Resources/snow.png");
-    unsigned int okTex   = loadTexture("Resources/check.png");
-
-    unsigned int digitTex[10];
-    for(int i = 0; i < 10; i++) {
-        std::string path = "Resources/digits/" + std::to_string(i) + ".png";
-        digitTex[i] = loadTexture(path.c_str());
-    }
-
-    unsigned int minusTex = loadTexture("Resources/minus.png");
+    // Cifre, minus i ikonice u jednom nizu tekstura - ceo displej je jedan poziv crtanja
+    const char* glyphPaths[GLYPH_COUNT] = {
+        "Resources/digits/0.png", "Resources/digits/1.png", "Resources/digits/2.png",
+        "Resources/digits/3.png", "Resources/digits/4.png", "Resources/digits/5.png",
+        "Resources/digits/6.png", "Resources/digits/7.png", "Resources/digits/8.png",
+        "Resources/digits/9.png", "Resources/minus.png", "Resources/fire.png",
+        "Resources/snow.png", "Resources/check.png"
+    };
+    unsigned int glyphTex = loadGlyphArray(glyphPaths, GLYPH_COUNT, 256);
 
     unsigned int nameTex = loadTexture("Resources/name.png");
 
@@ -261,8 +266,8 @@ int main(){
         float centerX2 = s2X + (screenW - (slotW*2 + 0.01f))/2;
         float centerY  = screenY + (screenH - slotH)/2 - 0.003f;
 
-        drawTemperature(centerX1, centerY, slotW, slotH, (int)desiredTemp, digitTex, minusTex);
-        drawTemperature(centerX2, centerY, slotW, slotH, (int)measuredTemp, digitTex, minusTex);
+        drawTemperature(centerX1, centerY, slotW, slotH, (int)desiredTemp);
+        drawTemperature(centerX2, centerY, slotW, slotH, (int)measuredTemp);
 
         // Icon
         float iconSize = 0.10f;
@@ -272,11 +277,13 @@ int main(){
         float iconDiff = desiredTemp - measuredTemp;
 
         if (std::fabs(iconDiff) < 0.5f)
-            drawQuad(iconX,iconY,iconSize,iconSize,okTex,1);
+            addGlyph(iconX,iconY,iconSize,iconSize,GLYPH_OK,1);
         else if (iconDiff > 0)
-            drawQuad(iconX,iconY,iconSize,iconSize,fireTex,1);
+            addGlyph(iconX,iconY,iconSize,iconSize,GLYPH_FIRE,1);
         else
-            drawQuad(iconX,iconY,iconSize,iconSize,snowTex,1);
+            addGlyph(iconX,iconY,iconSize,iconSize,GLYPH_SNOW,1);
+
+        drawGlyphs(glyphTex);
     }
 
 
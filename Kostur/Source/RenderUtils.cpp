@@ -2,9 +2,24 @@
 #include "../Header/Shader.h"
 #include "../Header/stb_image.h"
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 
 unsigned int quadVAO = 0, quadVBO = 0;
 extern Shader* basicShader;
+extern Shader* glyphShader;
+
+// x,y,w,h | r,g,b,alpha | sloj
+struct GlyphInstance {
+    float rect[4];
+    float color[4];
+    float layer;
+};
+
+static unsigned int glyphVAO = 0, glyphVBO = 0;
+static size_t glyphCapacity = 0;
+static std::vector<GlyphInstance> glyphs;
 
 void initQuad() {
     float vertices[] = {
@@ -72,3 +87,119 @@ void drawQuad(float x,float y,float w,float h,unsigned int texture,
     basicShader->setMat4("transform",t);
     glDrawArrays(GL_TRIANGLE_FAN,0,4);
 }
+
+// Bilinearno preskaliranje na zajednicku velicinu sloja
+static void resampleRGBA(const unsigned char* src,int w,int h,unsigned char* dst,int size)
+{
+    for(int y = 0; y < size; y++) {
+        float sy = std::max(0.0f, (y + 0.5f) * h / size - 0.5f);
+        int y0 = std::min((int)sy, h - 1);
+        int y1 = std::min(y0 + 1, h - 1);
+        float fy = sy - y0;
+
+        for(int x = 0; x < size; x++) {
+            float sx = std::max(0.0f, (x + 0.5f) * w / size - 0.5f);
+            int x0 = std::min((int)sx, w - 1);
+            int x1 = std::min(x0 + 1, w - 1);
+            float fx = sx - x0;
+
+            for(int c = 0; c < 4; c++) {
+                float p00 = src[((size_t)y0 * w + x0) * 4 + c];
+                float p10 = src[((size_t)y0 * w + x1) * 4 + c];
+                float p01 = src[((size_t)y1 * w + x0) * 4 + c];
+                float p11 = src[((size_t)y1 * w + x1) * 4 + c];
+                float top = p00 + (p10 - p00) * fx;
+                float bottom = p01 + (p11 - p01) * fx;
+                dst[((size_t)y * size + x) * 4 + c] = (unsigned char)std::lround(top + (bottom - top) * fy);
+            }
+        }
+    }
+}
+
+unsigned int loadGlyphArray(const char* const* paths,int count,int layerSize) {
+
+    stbi_set_flip_vertically_on_load(true);
+
+    unsigned int tex;
+    glGenTextures(1,&tex);
+    glBindTexture(GL_TEXTURE_2D_ARRAY,tex);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY,0,GL_RGBA8,layerSize,layerSize,count,0,GL_RGBA,GL_UNSIGNED_BYTE,nullptr);
+
+    std::vector<unsigned char> layer((size_t)layerSize * layerSize * 4, 0);
+
+    for(int i = 0; i < count; i++) {
+        int w,h,ch;
+        unsigned char* data = stbi_load(paths[i],&w,&h,&ch,4);
+
+        if(!data) {
+            std::cout<<"Failed to load "<<paths[i]<<"\n";
+            std::fill(layer.begin(), layer.end(), 0);
+        } else {
+            resampleRGBA(data,w,h,layer.data(),layerSize);
+            stbi_image_free(data);
+        }
+
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY,0,0,0,i,layerSize,layerSize,1,GL_RGBA,GL_UNSIGNED_BYTE,layer.data());
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    return tex;
+}
+
+void initGlyphs() {
+    glGenVertexArrays(1, &glyphVAO);
+    glGenBuffers(1, &glyphVBO);
+
+    glBindVertexArray(glyphVAO);
+
+    // Temena kvada se dele sa drawQuad
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(float), (void*)(2*sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, glyphVBO);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance), (void*)0);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance), (void*)(4*sizeof(float)));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance), (void*)(8*sizeof(float)));
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+
+    glBindVertexArray(0);
+}
+
+void addGlyph(float x,float y,float w,float h,int layer,
+              float alpha,float r,float g,float b)
+{
+    GlyphInstance gi = { {x, y, w, h}, {r, g, b, alpha}, (float)layer };
+    glyphs.push_back(gi);
+}
+
+void drawGlyphs(unsigned int glyphArray)
+{
+    if(glyphs.empty()) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, glyphVBO);
+    if(glyphs.size() > glyphCapacity) {
+        glyphCapacity = std::max<size_t>(glyphs.size(), 32);
+        glBufferData(GL_ARRAY_BUFFER, glyphCapacity * sizeof(GlyphInstance), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, glyphs.size() * sizeof(GlyphInstance), glyphs.data());
+
+    glyphShader->use();
+    glBindVertexArray(glyphVAO);
+    glBindTexture(GL_TEXTURE_2D_ARRAY,glyphArray);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN,0,4,(GLsizei)glyphs.size());
+
+    glyphs.clear();
+}
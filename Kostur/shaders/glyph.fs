@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec2 TexCoord;
+in vec4 Color;
+flat in float Layer;
+out vec4 FragColor;
+
+uniform sampler2DArray tex;
+
+void main() {
+    vec4 texColor = texture(tex, vec3(TexCoord, Layer));
+    FragColor = vec4(Color.rgb, 1.0) * texColor * vec4(1.0,1.0,1.0,Color.a);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aTex;
+
+// Po instanci: x,y,w,h kao kod drawQuad, boja+alpha i sloj niza
+layout(location = 2) in vec4 aRect;
+layout(location = 3) in vec4 aColor;
+layout(location = 4) in float aLayer;
+
+out vec2 TexCoord;
+out vec4 Color;
+flat out float Layer;
+
+void main() {
+    gl_Position = vec4(aRect.xy + aPos * aRect.zw, 0.0, 1.0);
+    TexCoord = aTex;
+    Color = aColor;
+    Layer = aLayer;
+}
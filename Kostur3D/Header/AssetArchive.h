@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Header/MappedFile.h"
+
+// Jedan fajl sa svim resursima (pravi ga alat KosturPack).
+// Raspored: zaglavlje, blobovi poravnati na ARCHIVE_ALIGN, tabela sadrzaja sortirana po hesu putanje, imena.
+// Slike mogu biti vec dekodirane u RGBA8 (okrenute kao posle decodeImage), sve ostalo su bajtovi fajla.
+static constexpr char     ARCHIVE_MAGIC[4] = { 'K', 'P', 'A', 'K' };
+static constexpr uint32_t ARCHIVE_VERSION  = 1;
+static constexpr uint64_t ARCHIVE_ALIGN    = 64;
+
+enum class ArchiveKind : uint32_t { Raw = 0, ImageRGBA8 = 1 };
+
+struct ArchiveHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+};
+
+struct ArchiveEntry {
+    uint64_t pathHash;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t contentHash;   // FNV-1a nad izvornim fajlom, isti kao srcHash u .meshbin
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    ArchiveKind kind;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ArchiveHeader) == 32, "archive header layout");
+static_assert(sizeof(ArchiveEntry) == 56, "archive entry layout");
+
+inline uint64_t Fnv1a64(const void* data, size_t n)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// "./res\\a.png" -> "res/a.png"
+std::string NormalizeAssetPath(const char* path);
+
+class AssetArchive {
+public:
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return file.IsOpen(); }
+
+    const ArchiveEntry* Find(const char* logicalPath) const;
+    const unsigned char* Data(const ArchiveEntry& e) const { return file.Data() + e.offset; }
+    size_t EntryCount() const { return entryCount; }
+
+    // Da li pokazivac pokazuje u mapiranu arhivu (takve piksele ne treba osloboditi)
+    bool Contains(const void* p) const;
+
+private:
+    MappedFile file;
+    const ArchiveEntry* entries = nullptr;
+    const char* names = nullptr;
+    size_t entryCount = 0;
+};
+
+extern AssetArchive gArchive;
+
+// Ceo sadrzaj logicke putanje: iz arhive ako je tamo, inace sa diska
+bool ReadAsset(const char* path, std::string& out);
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+#include "Header/ObjLoader.h"
+#include "Header/Renderer.h"
+#include "Header/UploadRing.h"
+
+// Dekodiranje slika i parsiranje OBJ-ova na radnim nitima.
+// GL kontekst ima samo glavna nit, pa ona prazni red gotovih podataka i radi upload.
+// Do uploada registar vraca belu 1x1 teksturu, a model se crta kao kutija granica iz kesa.
+// Teksture se traze preko gTextures, pa se ista putanja ucitava samo jednom.
+// Radna nit kopira nivoe teksture u slot gUploadRing-a, pa glavna nit samo zadaje kopiju iz PBO-a.
+// Kad pocetno ucitavanje zavrsi, Pump zadaje i strimovanje mipova koje trazi gTextures.
+class AssetLoader {
+public:
+    explicit AssetLoader(unsigned threadCount = 0);
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Zahtevi sa glavne niti i u toku rada; cekaju u pending dok trenutni poslovi ne zavrse
+    TextureHandle RequestTexture(const std::string& path);
+    // Niz tekstura pod imenom name: svaka slika se preskalira na layerSize x layerSize i postaje sloj
+    // (redosled = indeks sloja). Do uploada gTextures.Get vraca belu 2D teksturu, pa niz ne treba vezivati
+    TextureHandle RequestTextureArray(const std::string& name, const std::vector<std::string>& layerPaths, int layerSize);
+    // Ponovno ucitavanje ispecene teksture od nivoa level nanize (vise ili manje detalja)
+    void RequestTextureLevel(TextureHandle h, int level);
+    void RequestMesh(const std::string& objPath, const glm::vec4& color, MeshGL* target, bool* ok,
+                     VertexFormat format = VertexFormat::Float);
+    void RequestSubMeshes(const std::string& objPath, const glm::vec4& color, MeshGL* target, bool* ok,
+                          const std::vector<std::string>& onlyMaterials = {},
+                          VertexFormat format = VertexFormat::Float);
+
+    void Start();
+
+    // Upload spremnih zahteva dok ne istekne budzet (0 = sve spremno); vraca broj obradjenih
+    size_t Pump(Renderer& R, double budgetSeconds = 0.0);
+    // Blokira dok svi zahtevi ne budu ucitani i uploadovani
+    void Finish(Renderer& R);
+
+    bool Done() const;
+
+private:
+    // Ispeceni .ktx (mapiran, bez dekodiranja) ili dekodirani RGBA8 pikseli.
+    // Sa slotom su nivoi u file vec u PBO-u i njihovi data su offset-i u baferu.
+    struct Image {
+        int w = 0, h = 0;
+        unsigned char* pixels = nullptr;
+        TextureFile file;
+        UploadSlot slot;
+    };
+
+    static void LoadImage(const std::string& path, Image& img);
+    // Svi slojevi i ceo lanac mipmapa u storage; false ako neki sloj nije ucitan (ostaje providan)
+    static bool LoadImageArray(const std::vector<std::string>& paths, int size, std::vector<unsigned char>& storage, Image& img);
+    static void StageImage(Image& img);
+    static void ReleaseImage(Image& img);
+    static void UploadImage(TextureHandle h, Image& img);
+
+    struct Job {
+        enum class Kind { Texture, TextureLevels, TextureArray, Mesh, SubMeshes } kind = Kind::Texture;
+        std::string path;
+        glm::vec4 color {1.0f};
+        std::vector<std::string> onlyMaterials;
+        VertexFormat format = VertexFormat::Float;
+
+        TextureHandle tex;
+        int level = 0;
+        std::vector<std::string> layerPaths;
+        int layerSize = 0;
+        std::vector<unsigned char> layerPixels;
+        MeshGL* meshTarget = nullptr;
+        bool* okTarget = nullptr;
+
+        bool ok = false;
+        Image image;
+        ObjPayload obj;
+        std::map<std::string, Image> objTextures;
+    };
+
+    void Push(std::unique_ptr<Job> job);
+    void TakePending();
+    void SetMeshPlaceholder(Job& job);
+    void WorkerMain();
+    void Run(Job& job);
+    void Upload(Job& job, Renderer& R);
+
+    std::vector<std::pair<TextureHandle, int>> streamRequests;
+    std::vector<std::unique_ptr<Job>> jobs;
+    mutable std::mutex pendingMutex;
+    std::vector<std::unique_ptr<Job>> pending;
+    std::vector<std::thread> workers;
+    unsigned threadCount = 0;
+
+    std::atomic<size_t> nextJob {0};
+    size_t uploaded = 0;
+
+    std::mutex readyMutex;
+    std::condition_variable readyCv;
+    std::deque<Job*> ready;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Sest ravni (levo, desno, dole, gore, blizu, daleko) u svetu; normala gleda ka unutra i
+// normalizovana je, pa je dot(n, p) + w rastojanje tacke od ravni u metrima
+struct Frustum {
+    glm::vec4 planes[6];
+};
+
+// Iz P * V (Gribb/Hartmann); za GL clip prostor (-w..w po z)
+Frustum ExtractFrustum(const glm::mat4& VP);
+
+bool SphereInFrustum(const Frustum& f, const glm::vec3& center, float radius);
+// Kutija poravnata sa osama u svetu, zadata centrom i polu-ivicama
+bool BoxInFrustum(const Frustum& f, const glm::vec3& center, const glm::vec3& halfExtent);
+
+// Sfere u SoA rasporedu; visible[i] je 1 ako sfera i sece frustum, inace 0.
+// Po cetiri sfere odjednom: SSE na x86, NEON na ARM-u (macOS arm64), inace skalarno.
+void CullSpheres(const Frustum& f, const float* x, const float* y, const float* z, const float* radius,
+                 size_t count, uint8_t* visible);
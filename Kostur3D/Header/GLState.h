@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <GL/glew.h>
+
+// Senka GL stanja: pamti sta je poslednje poslato i preskace poziv koji nista ne bi promenio.
+// Renderer sve program/VAO/teksture/bafere/mogucnosti menja samo kroz ovo.
+// Ucitavanje tekstura i pravljenje mesha van frejma vezuju direktno, pa BeginFrame zaboravlja
+// vezivanja; ukljucene mogucnosti, blend, dubina i program menja samo ova klasa i ostaju poznati.
+class GLStateCache {
+public:
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    // glActiveTexture + glBindTexture; jedinica se menja samo kad treba
+    void BindTexture(GLuint unit, GLenum target, GLuint tex);
+    // GL_ARRAY_BUFFER i GL_UNIFORM_BUFFER (GL_ELEMENT_ARRAY_BUFFER je deo VAO-a i ne prati se)
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindUniformBase(GLuint index, GLuint buffer);
+    void BindUniformRange(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    // GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_POLYGON_OFFSET_FILL
+    void Enable(GLenum cap, bool on);
+    void BlendFunc(GLenum src, GLenum dst);
+    void DepthMask(bool on);
+    // Sva cetiri kanala zajedno (iskljucuje se samo za upite zaklonjenosti)
+    void ColorMask(bool on);
+    void PolygonOffset(float factor, float units);
+    // Vrednost se pamti po programu i lokaciji
+    void Uniform1i(GLint location, GLint value);
+
+    // Brisanje vezanog objekta vraca vezivanje na 0, a ime moze odmah da se dobije ponovo;
+    // zato se brise kroz senku
+    void DeleteVertexArray(GLuint& vao);
+    void DeleteBuffer(GLuint& buffer);
+
+    // Pocetak Submit-a: brojaci frejma se pamte i nuliraju, vezivanja postaju nepoznata
+    void BeginFrame();
+    // Sve nepoznato, sledeci poziv svake vrste ide do drajvera
+    void Invalidate();
+    void PrintStats() const;
+
+private:
+    static constexpr GLuint UNKNOWN = ~0u;
+    static constexpr int MAX_UNITS = 4;
+    static constexpr int MAX_UNIFORM_BINDINGS = 4;
+    enum Cap { CAP_BLEND, CAP_DEPTH, CAP_CULL, CAP_OFFSET, CAP_COUNT };
+
+    struct UniformRange {
+        GLuint buffer = UNKNOWN;
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;
+    };
+    struct UniformValue {
+        GLuint program;
+        GLint location;
+        GLint value;
+    };
+
+    void InvalidateBindings();
+    // true ako poziv treba poslati; broji oba slucaja
+    bool Changed(bool changed);
+
+    GLuint program = UNKNOWN;
+    GLuint vao = UNKNOWN;
+    GLuint activeUnit = UNKNOWN;
+    GLuint textures[MAX_UNITS] = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+    GLenum textureTargets[MAX_UNITS] = {};
+    GLuint arrayBuffer = UNKNOWN;
+    GLuint uniformBuffer = UNKNOWN;
+    UniformRange uniformRanges[MAX_UNIFORM_BINDINGS];
+
+    int caps[CAP_COUNT] = { -1, -1, -1, -1 };   // -1 nepoznato
+    GLenum blendSrc = 0, blendDst = 0;
+    int depthMask = -1;
+    int colorMask = -1;
+    float offsetFactor = 0.0f, offsetUnits = 0.0f;
+    bool offsetKnown = false;
+    std::vector<UniformValue> uniforms;
+
+    size_t issued = 0, elided = 0;
+    size_t lastIssued = 0, lastElided = 0;
+};
+
+extern GLStateCache gGLState;
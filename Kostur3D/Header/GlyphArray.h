@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+#include "Header/StreamBuffer.h"
+#include "Header/TextureRegistry.h"
+
+// Slojevi niza tekstura za displej klime (cifra d je sloj d)
+enum GlyphLayer : int {
+    GLYPH_DIGIT0 = 0,
+    GLYPH_MINUS = 10,
+    GLYPH_FIRE,
+    GLYPH_SNOW,
+    GLYPH_OK,
+    GLYPH_COUNT
+};
+
+// Po instanci: centar u lokalnom prostoru displeja + sloj, velicina, boja
+struct GlyphInstance {
+    float pos[3];
+    float layer;
+    float size[2];
+    float pad[2];
+    float tint[4];
+};
+
+static_assert(sizeof(GlyphInstance) == 48, "glyph instance layout");
+
+// Svi znakovi displeja u jednom GL_TEXTURE_2D_ARRAY i jedan instancirani poziv za ceo displej.
+// Niz pravi AssetLoader::RequestTextureArray (slike se preskaliraju na zajednicku velicinu sloja;
+// UV je i ranije pokrivao celu sliku pa se izgled ne menja); do uploada se znakovi ne crtaju.
+struct GlyphArray {
+    TextureHandle texture;
+    GLuint vao = 0;
+    GLuint quadVbo = 0;
+    std::vector<GlyphInstance> instances;
+
+    // Preuzima referencu na niz iz gTextures; Destroy je pusta
+    void Init(TextureHandle tex);
+    void Destroy();
+
+    void Clear() { instances.clear(); }
+    void Add(const glm::vec3& center, const glm::vec2& size, int layer, const glm::vec4& tint);
+    // Upisuje instance u stream bafer frejma i usmerava atribute 4-6 na njih (VAO ostaje vezan);
+    // vraca broj znakova za crtanje
+    GLsizei Upload(StreamBuffer& stream);
+};
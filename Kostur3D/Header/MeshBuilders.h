@@ -10,3 +10,6 @@ void BuildCylinder(std::vector<float>& out,
 void BuildSphere(std::vector<float>& out,
                  float radius, int seg, int rings,
                  const glm::vec4& color);
+
+// Kocka ivice 0.2 oko koordinatnog pocetka; 4 verteksa po stranici, redom kao CubeFace
+void BuildCube(std::vector<float>& out);
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <glm/glm.hpp>
+#include "Header/MappedFile.h"
+#include "Header/MeshData.h"
+
+// Binarni kes OBJ modela (.meshbin pored izvornog fajla).
+// Kljuc je velicina/mtime/hash izvora + boja upisana u verteks + velicina/hash .mtl iz mtllib.
+struct MeshCacheView {
+    MappedFile file;
+    const float* vertices = nullptr;
+    size_t floatCount = 0;
+    const uint32_t* indices = nullptr;
+    size_t indexCount = 0;
+    const MeshRange* ranges = nullptr;
+    size_t rangeCount = 0;
+    const MeshLod* lods = nullptr;
+    size_t lodCount = 0;
+};
+
+std::string MeshCachePath(const char* srcPath);
+
+bool OpenMeshCache(const char* srcPath, const glm::vec4& color, MeshCacheView& out);
+// Samo zaglavlje, bez provere sadrzaja - za placeholder dok se model ucitava
+bool PeekMeshCacheBounds(const char* srcPath, const glm::vec4& color, glm::vec3& outMin, glm::vec3& outMax);
+bool SaveMeshCache(const char* srcPath, const glm::vec4& color, const MeshData& mesh);
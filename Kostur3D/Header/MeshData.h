@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static constexpr int MESH_STRIDE_FLOATS = 12;
+
+// Raspon indeksa jednog materijala unutar zajednickog bafera
+struct MeshRange {
+    uint32_t first = 0;
+    uint32_t count = 0;
+    int32_t materialId = -1;
+    char name[52] = {};
+    char diffuseTex[64] = {};
+};
+
+// Nivo detalja: raspon indeksa nad istim verteksima.
+// error je najveca geometrijska greska u odnosu na original, u jedinicama modela.
+struct MeshLod {
+    uint32_t first = 0;
+    uint32_t count = 0;
+    float error = 0.0f;
+    uint32_t reserved = 0;
+};
+
+struct MeshData {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshRange> ranges;
+    // Prazno ili lods[0] = pun model; ostali nivoi su dodati na kraj indices
+    std::vector<MeshLod> lods;
+
+    size_t VertexCount() const { return vertices.size() / MESH_STRIDE_FLOATS; }
+};
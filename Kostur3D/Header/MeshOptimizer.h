@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Header/MeshData.h"
+
+// Reorganizacija indeksiranih mreza posle ucitavanja (ili pre upisa u .meshbin):
+// 1) redosled trouglova za post-transform kes (Tipsify),
+// 2) redosled klastera za manji overdraw (spolja okrenuti klasteri prvi),
+// 3) redosled verteksa po prvoj upotrebi, za lokalnost pri dohvatanju.
+static constexpr unsigned MESH_OPT_CACHE_SIZE = 16;
+
+// Prosecan broj promasaja kesa po trouglu (FIFO simulacija)
+float ComputeACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize = MESH_OPT_CACHE_SIZE);
+
+// clusters dobija pocetne trouglove (ne indekse) tvrdih granica klastera
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount,
+                         std::vector<uint32_t>* clusters = nullptr, unsigned cacheSize = MESH_OPT_CACHE_SIZE);
+
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const float* vertices, size_t vertexCount,
+                      const std::vector<uint32_t>& clusters);
+
+void OptimizeVertexFetch(std::vector<float>& vertices, std::vector<uint32_t>& indices);
+
+// Sve tri faze; svaki raspon materijala se obradjuje posebno. name se koristi samo za ispis.
+void OptimizeMesh(MeshData& mesh, const char* name = nullptr);
+
+// Indeksirana mreza od neindeksiranog niza (npr. BuildCylinder/BuildSphere), spaja identicne verteks zapise
+void MeshDataFromFloats(const std::vector<float>& data, MeshData& out);
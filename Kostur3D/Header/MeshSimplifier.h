@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Header/MeshData.h"
+
+// Pojednostavljivanje mreze skupljanjem ivica po kvadrikama greske (QEM).
+// Verteksi se ne pomeraju niti dodaju, samo se menjaju indeksi - svi nivoi dele isti VBO.
+// Verteksi na UV/normal savovima ostaju zakljucani, ivice otvorenih rubova klize samo duz ruba.
+static constexpr int MESH_MAX_LODS = 4;
+
+// Vraca broj indeksa u out; outError je najveca greska (udaljenost) ovog prolaza
+size_t SimplifyMesh(std::vector<uint32_t>& out, const uint32_t* indices, size_t indexCount,
+                    const float* vertices, size_t vertexCount, size_t targetIndexCount, float* outError = nullptr);
+
+// Dodaje nivoe 1..MESH_MAX_LODS-1 (pola, cetvrtina, osmina trouglova) na kraj mesh.indices.
+// Svaki raspon materijala se pojednostavljuje posebno. name se koristi samo za ispis.
+void BuildMeshLods(MeshData& mesh, const char* name = nullptr);
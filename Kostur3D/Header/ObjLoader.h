@@ -0,0 +1,36 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Header/MeshCache.h"
+#include "Header/MeshData.h"
+#include "Header/Renderer.h"
+
+bool ParseObjToMeshData(const char* objPath, const glm::vec4& color, MeshData& out);
+
+// CPU deo ucitavanja (bez GL poziva), moze da radi na radnoj niti.
+// Pokazivaci u view vaze i kada model nije bio u kesu (tada pokazuju u parsed).
+struct ObjPayload {
+    MeshCacheView view;
+    MeshData parsed;
+    std::string baseDir;
+};
+
+bool LoadObjPayload(const char* objPath, const glm::vec4& color, ObjPayload& out);
+std::vector<std::string> ObjDiffuseTextures(const ObjPayload& p, const std::vector<std::string>& onlyMaterials = {});
+
+void UploadObjMesh(const ObjPayload& p, Renderer& R, MeshGL& outMesh, VertexFormat format = VertexFormat::Float);
+bool UploadObjSubMeshes(const ObjPayload& p, Renderer& R, MeshGL& outMesh,
+                        const std::vector<std::string>& onlyMaterials,
+                        const std::function<TextureHandle(const std::string&)>& textureFor,
+                        VertexFormat format = VertexFormat::Float);
+
+bool LoadObjToMeshGL(const char* objPath, Renderer& R, MeshGL& outMesh, const glm::vec4& color,
+                     VertexFormat format = VertexFormat::Float);
+
+// Jedan VBO/EBO za ceo fajl i po jedan SubMesh (raspon indeksa) za svaki materijal.
+// Ako je onlyMaterials zadat, ucitavaju se samo ti materijali, tim redosledom.
+bool LoadObjToSubMeshes(const char* objPath, Renderer& R, MeshGL& outMesh, const glm::vec4& color,
+                        const std::vector<std::string>& onlyMaterials = {},
+                        VertexFormat format = VertexFormat::Float);
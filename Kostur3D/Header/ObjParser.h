@@ -0,0 +1,9 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "Header/MeshData.h"
+
+// Brzi OBJ citac: fajl se mapuje u memoriju, deli na delove poravnate na kraj reda
+// i delovi se parsiraju paralelno. Podrzani su v/vt/vn/f (trouglovi i cetvorouglovi),
+// usemtl i mtllib; sve ostalo (linije, krive, poligoni sa 5+ temena...) vraca false
+// i pozivalac prelazi na tinyobj.
+bool FastParseObjToMeshData(const char* objPath, const glm::vec4& color, MeshData& out);
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Sobe su kutije poravnate sa osama, portali pravougaonici na zajednickoj strani dve sobe
+// (vrata, otvor bez zida). Svakog frejma se od sobe u kojoj je kamera ide kroz portale;
+// pravougaonik portala na ekranu se sece sa pravougaonikom kroz koji se gleda, pa je soba
+// vidljiva samo ako se do nje stize kroz neprazan presek. Rezultat je konzervativan:
+// soba moze biti oznacena kao vidljiva iako je zaklonjena, ali nikad obrnuto.
+class PortalGraph {
+public:
+    // Sobe se proveravaju redom kojim su dodate, pa poslednja moze biti "spolja" preko svega
+    int AddRoom(const std::string& name, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    // Kutija debljine nula po jednoj osi, na granici soba a i b
+    void AddPortal(int a, int b, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+    // -1 ako tacka nije ni u jednoj sobi
+    int RoomAt(const glm::vec3& p) const;
+
+    // VP = P * V kamere; bez sobe oko kamere sve sobe su vidljive
+    void Update(const glm::vec3& eye, const glm::mat4& VP);
+    // Po sobi 1 ako je vidljiva u poslednjem Update
+    const std::vector<uint8_t>& Visible() const { return visible; }
+    size_t RoomCount() const { return rooms.size(); }
+
+    void PrintStats() const;
+
+private:
+    struct Room {
+        std::string name;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        std::vector<int> portals;
+    };
+
+    struct Portal {
+        int a = -1, b = -1;
+        int axis = 0;          // osa normale
+        float plane = 0.0f;    // koordinata ravni po toj osi
+        float sideB = 1.0f;    // +1 ako je b na pozitivnoj strani ravni
+        glm::vec3 corners[4];
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    // Pravougaonik u NDC
+    struct Rect {
+        float x0 = -1.0f, y0 = -1.0f, x1 = 1.0f, y1 = 1.0f;
+        bool Empty() const { return x0 >= x1 || y0 >= y1; }
+    };
+
+    void Visit(int room, const Rect& view, int depth);
+    bool ProjectPortal(const Portal& p, Rect& out) const;
+
+    std::vector<Room> rooms;
+    std::vector<Portal> portals;
+    std::vector<uint8_t> visible;
+    std::vector<uint8_t> onPath;   // portali na trenutnom putu (bez vracanja kroz isti)
+
+    glm::vec3 eye {0.0f};
+    glm::mat4 viewProj {1.0f};
+
+    int lastEyeRoom = -1;
+    size_t lastPortalsPassed = 0;
+    size_t lastVisibleRooms = 0;
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+
+struct MeshGL;
+struct GlyphArray;
+struct Frustum;
+
+// Prolazi se izvrsavaju redom; u okviru prolaza redosled odredjuje kljuc
+enum class RenderPass : uint8_t {
+    World = 0,     // scena
+    Overlay = 1,   // predmeti u ruci, posle brisanja dubine
+    Hud = 2        // 2D preko svega
+};
+
+enum class DrawKind : uint8_t {
+    Cube, Mesh, TexturedMesh, SubMeshes, TexturedCube, TexturedCubeFace,
+    Screen, Glyphs, Overlay, Center, ClearDepth
+};
+
+// GL stanje koje se pamti uz svaki snimljeni poziv (ranije se menjalo direktno iz main-a)
+struct DrawState {
+    bool cull = true;
+    bool depthTest = true;
+    bool depthWrite = true;
+    bool polygonOffset = false;
+    bool unlit = false;
+    float emissive = 0.0f;
+};
+
+struct DrawPacket {
+    uint64_t key = 0;
+    DrawKind kind = DrawKind::Cube;
+    DrawState state;
+
+    const MeshGL* mesh = nullptr;
+    GlyphArray* glyphs = nullptr;
+    GLuint tex = 0;
+    glm::mat4 M {1.0f};
+    glm::vec4 tint {1.0f};
+    glm::vec4 faceTint {1.0f};
+    int face = 0;
+    float lift = 0.0f;
+    bool transparent = false;
+
+    // Granice u svetu za odstranjivanje van kadra: kutija (centar, polu-ivice) i sfera oko istog
+    // centra. radius < 0 - paket se uvek crta (HUD, brisanje dubine, znakovi)
+    glm::vec3 boundsCenter {0.0f};
+    glm::vec3 boundsExtent {0.0f};
+    float boundsRadius = -1.0f;
+    // Soba iz PortalGraph; -1 - ne pripada sobi (pokretni predmeti, HUD)
+    int room = -1;
+};
+
+// 64-bitni kljuc, od najvisih bitova: prolaz (2), providnost (1), pa
+//   neprovidno: program (6), tekstura (12), mesh (12), dubina (24) - grupisano po stanju, spreda ka nazad
+//   providno:   obrnuta dubina (24), program, tekstura, mesh    - od nazad ka napred
+// depth je rastojanje od kamere u metrima.
+uint64_t MakeSortKey(RenderPass pass, bool blended, uint32_t shader, uint32_t texture, uint32_t mesh, float depth);
+
+// Pozivi za crtanje jednog frejma; Renderer ih snima, a na kraju frejma izvrsava sortirane
+class RenderQueue {
+public:
+    void Push(const DrawPacket& p) { packets.push_back(p); }
+
+    // Pre Sort: izbacuje pakete iz soba koje nisu vidljive (visibleRooms[room] == 0; prazno -
+    // sve sobe) i pakete cije granice su van frustuma. Sfere se testiraju po cetiri
+    // odjednom (CullSpheres), a one koje prodju jos i kutijom
+    void Cull(const Frustum& f, const std::vector<uint8_t>& visibleRooms);
+
+    // Sortira indekse po kljucu; medju jednakim kljucevima ostaje redosled snimanja
+    void Sort();
+    size_t Size() const { return packets.size(); }
+    const DrawPacket& operator[](size_t i) const { return packets[order[i].second]; }
+
+    void Clear();
+    void PrintStats() const;
+
+private:
+    std::vector<DrawPacket> packets;
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+
+    // Sfere u SoA rasporedu za Cull; indeks paketa uz svaku
+    std::vector<float> cullX, cullY, cullZ, cullR;
+    std::vector<uint32_t> cullIndex;
+    std::vector<uint8_t> cullSphere;    // po sferi
+    std::vector<uint8_t> cullVisible;   // po paketu
+
+    // Poslednji frejm: paketi i grupe uzastopnih paketa sa istim programom, teksturom i meshom
+    size_t lastPackets = 0;
+    size_t lastBatches = 0;
+    size_t lastUnsortedBatches = 0;
+    size_t lastTested = 0;
+    size_t lastCulled = 0;
+    size_t lastRoomCulled = 0;
+};
@@ -1,15 +1,113 @@
 #pragma once
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <glm/glm.hpp>
 #include <GL/glew.h>
+#include "Header/TextureRegistry.h"
+#include "Header/GlyphArray.h"
+#include "Header/RenderQueue.h"
+#include "Header/StreamBuffer.h"
+#include "Header/Frustum.h"
 
 enum class CubeFace : int { Front=0, Left=1, Bottom=2, Top=3, Right=4, Back=5 };
 
+// Float: 12 float-ova (48 B) po verteksu.
+// Packed: 16 B - pozicija u unorm16 unutar AABB-a, normala u 2_10_10_10, UV u half float;
+// boja je ista za ceo model pa ide kao konstantan atribut umesto po verteksu.
+enum class VertexFormat { Float, Packed };
+
+struct SubMesh {
+    GLsizei first = 0;
+    GLsizei count = 0;
+    int materialId = -1;
+    TextureHandle tex;
+    std::string name;
+    // UV u 0..1 (spojene kocke); materijali iz OBJ-a ponavljaju teksturu
+    bool clampUV = false;
+};
+
+struct LodLevel {
+    GLsizei first = 0;
+    GLsizei count = 0;
+    float error = 0.0f;
+};
+
 struct MeshGL {
     GLuint vao = 0;
     GLuint vbo = 0;
+    GLuint ebo = 0;
     GLsizei vertexCount = 0; 
+    GLsizei indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
     bool isCubeFans = false; 
+    std::vector<SubMesh> parts;
+    // lods[0] je pun model; prazno znaci bez nivoa detalja
+    std::vector<LodLevel> lods;
+
+    VertexFormat format = VertexFormat::Float;
+    glm::vec3 posScale {1.0f};
+    glm::vec3 posOffset {0.0f};
+    glm::vec4 color {1.0f};
+
+    // Dok se pravi model ucitava crta se kutija ovih granica
+    bool isPlaceholder = false;
+    // Lokalne granice, racunaju se pri pravljenju; sfera je oko centra kutije
+    glm::vec3 boundsMin {0.0f};
+    glm::vec3 boundsMax {0.0f};
+    glm::vec3 sphereCenter {0.0f};
+    float sphereRadius = 0.0f;
+};
+
+// Granice bez verteksa (npr. iz zaglavlja kesa); sfera opisuje kutiju
+void SetMeshBounds(MeshGL& m, const glm::vec3& bmin, const glm::vec3& bmax);
+
+// std140 blokovi iz basic.vert/basic.frag - raspored mora da prati shader.
+// Frame se salje jednom po frejmu, Draw za svaki poziv; oba idu kroz stream bafer (glBindBufferRange).
+struct FrameUniforms {
+    glm::mat4 V {1.0f};
+    glm::mat4 P {1.0f};
+    glm::vec4 lightPos {0.0f};
+    glm::vec4 lightColor {0.0f};    // w = snaga
+    glm::vec4 lightPos2 {0.0f};
+    glm::vec4 lightColor2 {0.0f};   // w = snaga
+    glm::vec4 ambient {0.0f};       // x
+};
+
+struct DrawUniforms {
+    glm::mat4 M {1.0f};
+    glm::vec4 tint {1.0f};
+    glm::vec4 posScale {1.0f};      // xyz, dekvantizacija Packed formata
+    glm::vec4 posOffset {0.0f};     // xyz
+    glm::ivec4 flags {0};           // x useTex, y unlit, z DrawMode
+    glm::vec4 params {0.0f};        // x emissive
+};
+
+static_assert(sizeof(FrameUniforms) == 208, "std140 Frame");
+static_assert(sizeof(DrawUniforms) == 144, "std140 Draw");
+
+// Kako verteks shader dobija poziciju (flags.z)
+enum DrawMode : int {
+    DRAW_MODE_MESH = 0,
+    DRAW_MODE_GLYPHS = 1,      // instancirani znakovi, lokacije 4-6
+    DRAW_MODE_SCREEN = 3       // HUD: M vodi pravo u clip prostor, bez V i P
+};
+
+// Skup model koji se crta samo ako je njegova granicna kutija bila vidljiva u poslednjem
+// procitanom upitu (GL_ANY_SAMPLES_PASSED). Rezultat se cita frejm ili vise kasnije, pa
+// nema cekanja na GPU; dok upit ceka, vazi poslednji poznat rezultat.
+struct OcclusionQuery {
+    std::string name;
+    GLuint query = 0;
+    bool pending = false;       // poslat, rezultat jos nije procitan
+    bool visible = true;        // poslednji poznat rezultat
+    bool requested = false;     // OcclusionTest u ovom frejmu
+    int room = -1;
+    glm::vec3 boxCenter {0.0f};
+    glm::vec3 boxExtent {0.0f};
+
+    // Od pokretanja: frejmova sa OcclusionTest, od toga preskocenih i poslatih upita
+    size_t frames = 0, skipped = 0, issued = 0;
 };
 
 struct Renderer {
@@ -20,32 +118,114 @@ struct Renderer {
     MeshGL overlayQuad;
 
 
-    GLuint overlayTex = 0;
+    TextureHandle overlayTex;
 
     GLuint shader = 0;
-    GLint uM = -1, uV = -1, uP = -1;
-    GLint uUseTex = -1, uTransparent = -1, uTint = -1;
-    GLint uTex = -1;
+    // Jedine obicne uniforme su sampleri; sve ostalo je u blokovima
+    GLint uTex = -1, uGlyphTex = -1;
+
+    // Sve sto se menja svakog frejma: instance, Frame blok (tacka 0) i Draw blokovi (tacka 1)
+    StreamBuffer stream;
+    size_t uniformAlign = 256;     // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    FrameUniforms frame;
+    DrawUniforms draw;
+    // Poslednji poslat blok; isti blok se ne salje ponovo
+    DrawUniforms lastDraw;
+    bool lastDrawValid = false;
+    size_t drawUploads = 0, drawReuses = 0;   // poslednji frejm
+
+    // Za izbor nivoa detalja: kamera iz poslednjeg SetCommonUniforms
+    glm::vec3 lodEye {0.0f};
+    float lodPixelsPerUnit = 0.0f;
+    float lodMaxPixelError = 1.0f;
+    // Iz P * V poslednjeg SetCommonUniforms; Submit odbacuje pakete van njega
+    Frustum frustum;
 
     MeshGL centerQuad;
-    GLuint centerTex = 0;
+    TextureHandle centerTex;
     MeshGL screenQuad;
 
     bool Init(GLuint shaderProgram, const char* overlayPath);
     void Destroy();
+    // Brise GL bafere i pusta teksture delova
+    void DestroyMesh(MeshGL& m);
 
     void CreateCube();
+    void CreateStreamBuffer();
     void CreateFromFloats(MeshGL& m, const std::vector<float>& data, bool cubeFans = false);
+    void CreateFromFloats(MeshGL& m, const float* data, size_t floatCount, bool cubeFans = false);
+    void CreateIndexed(MeshGL& m, const float* data, size_t floatCount, const uint32_t* indices, size_t indexCount);
+    void CreatePacked(MeshGL& m, const float* data, size_t floatCount, const uint32_t* indices, size_t indexCount);
+    void CreateMesh(MeshGL& m, VertexFormat format, const float* data, size_t floatCount, const uint32_t* indices, size_t indexCount);
+    void ApplyMeshFormat(const MeshGL& m);
+
+    void SetCommonUniforms(const glm::mat4& V, const glm::mat4& P, float viewportHeight = 0.0f);
+    // Svetla idu u Frame blok; salje se u Submit zajedno sa V i P
+    void SetLight(int index, const glm::vec3& pos, const glm::vec3& color, float power);
+    void SetAmbient(float ambient);
+    int SelectLod(const MeshGL& m, const glm::mat4& M) const;
+    // Precnik granicne sfere na ekranu u pikselima (za strimovanje mipova); velik broj ako je kamera u sferi
+    float ProjectedPixels(const MeshGL& m, const glm::mat4& M) const;
+
+    // Draw* samo snimaju poziv u red, sa trenutnim state i pass; Submit na kraju frejma
+    // sortira red po kljucu i tek tada crta (neprovidno spreda ka nazad, providno od nazad ka napred)
+    DrawState state;
+    RenderPass pass = RenderPass::World;
+    // Soba kojoj pripadaju sledeci pozivi (-1 - nijednoj); visibleRooms postavlja PortalGraph
+    // svakog frejma, prazno znaci da su sve sobe vidljive
+    int room = -1;
+    std::vector<uint8_t> visibleRooms;
+    RenderQueue queue;
+
+    // Upiti zaklonjenosti; kutije se crtaju u Submit posle neprovidnog dela scene
+    std::vector<OcclusionQuery> occlusion;
+    bool occlusionOn = true;
+
+    // Jednom pri ucitavanju; vraca id za OcclusionTest
+    int CreateOcclusionQuery(const std::string& name);
+    // Pre snimanja modela: false ako je bio zaklonjen (tada se ne crta). Snima i upit za ovaj frejm
+    bool OcclusionTest(int id, const MeshGL& m, const glm::mat4& M);
+
+    void Submit();
+    // Red, GL stanje i uniform baferi u poslednjem frejmu
+    void PrintStats() const;
+    // Brisanje dubine na pocetku trenutnog prolaza
+    void ClearDepth();
 
-    void SetCommonUniforms(const glm::mat4& V, const glm::mat4& P);
     void DrawCube(const glm::mat4& M, const glm::vec4& tint, bool transparent);
     void DrawMeshTriangles(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint, bool transparent);
     void DrawOverlay();
     void DrawTexturedMesh(const MeshGL& m, const glm::mat4& M, GLuint texID, const glm::vec4& tint = glm::vec4(1.0f));
+    void DrawSubMeshes(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint = glm::vec4(1.0f));
     void DrawCenter();
     void CreateScreenQuad();
     void DrawTexturedScreen(const glm::mat4& M, GLuint texID, const glm::vec4& tint = glm::vec4(1,1,1,1));
+    // Svi dodati znakovi jednim instanciranim pozivom; M postavlja displej u svet
+    void DrawGlyphs(GlyphArray& glyphs, const glm::mat4& M);
     void DrawTexturedCube(const glm::mat4& M, GLuint tex, const glm::vec4& tint = glm::vec4(1,1,1,1));
     void DrawTexturedCubeFace(const glm::mat4& M, GLuint tex, const glm::vec4& baseTint,  const glm::vec4& faceTint,  CubeFace face, float lift = 0.001f);
 
+    // Izvrsavanje paketa (samo iz Submit)
+    DrawPacket Record(DrawKind kind, const MeshGL* mesh, const glm::mat4& M, GLuint tex, bool blended) const;
+    // GL deo ide kroz gGLState, unlit i emissive u Draw blok
+    void ApplyState(const DrawState& s);
+    void SetDraw(const glm::mat4& M, const glm::vec4& tint, int useTex, DrawMode mode = DRAW_MODE_MESH);
+    // Upisuje draw u stream bafer i vezuje ga; zove se pre svakog glDraw*.
+    // false ako u baferu nema mesta - tada se poziv preskace
+    bool CommitDraw();
+    void Execute(const DrawPacket& p);
+    // Kutije trazenih upita, bez upisa boje i dubine
+    void IssueOcclusionQueries();
+    void IssueCube(const glm::mat4& M, const glm::vec4& tint, bool transparent);
+    void IssuePlaceholder(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint);
+    void IssueMeshTriangles(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint, bool transparent);
+    void IssueOverlay();
+    void IssueTexturedMesh(const MeshGL& m, const glm::mat4& M, GLuint texID, const glm::vec4& tint);
+    void IssueSubMeshes(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint);
+    void IssueCenter();
+    void IssueTexturedScreen(const glm::mat4& M, GLuint texID, const glm::vec4& tint);
+    void IssueGlyphs(GlyphArray& glyphs, const glm::mat4& M);
+    void IssueTexturedCube(const glm::mat4& M, GLuint tex, const glm::vec4& tint);
+    void IssueTexturedCubeFace(const glm::mat4& M, GLuint tex, const glm::vec4& baseTint, const glm::vec4& faceTint, CubeFace face, float lift);
+
 };
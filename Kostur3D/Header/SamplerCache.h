@@ -0,0 +1,34 @@
+#pragma once
+#include <GL/glew.h>
+
+// Nacin uzorkovanja ne pripada teksturi nego mestu crtanja: svaka tekstura ima pune mipmape,
+// a filter i wrap dolaze iz deljenog sampler objekta vezanog na jedinicu.
+enum class SamplerPreset : int {
+    TrilinearClamp = 0,  // HUD, ekrani, znakovi
+    TrilinearRepeat,
+    AnisoClamp,          // zidovi, pod, predmeti (UV 0..1 preko cele stranice)
+    AnisoRepeat,         // materijali iz OBJ-a (UV moze da izadje iz 0..1)
+    Count
+};
+
+class SamplerCache {
+public:
+    // Posle glewInit; bez EXT_texture_filter_anisotropic Aniso* su isto sto i Trilinear*
+    void Init(float maxAnisotropy = 8.0f);
+    void Destroy();
+
+    GLuint Get(SamplerPreset p) const { return samplers[(int)p]; }
+    // Preskace poziv ako je na jedinici vec isti sampler
+    void Bind(GLuint unit, SamplerPreset p);
+
+    float Anisotropy() const { return anisotropy; }
+
+private:
+    static constexpr int MAX_UNITS = 4;
+
+    GLuint samplers[(int)SamplerPreset::Count] = {};
+    GLuint bound[MAX_UNITS] = {};
+    float anisotropy = 1.0f;
+};
+
+extern SamplerCache gSamplers;
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Header/Renderer.h"
+#include "Header/TextureRegistry.h"
+
+// Nepokretna geometrija scene. Pri ucitavanju se kocke transformisu u svet (pozicija, normala,
+// tint ide u boju verteksa) i grupisu po teksturi; svaka grupa je jedan opseg indeksa u zajednickom
+// baferu i crta se jednim glDrawElements. Zidovi idu bez odstranjivanja nalicja, pa se odvojeno
+// prave meshevi sa i bez odstranjivanja. Scena se jos deli na celije u xz ravni (po centru kocke),
+// jedan mesh po celiji, da bi se ono sto je van kadra odbacilo cele celije.
+class StaticBatch {
+public:
+    // Soba (PortalGraph) kojoj pripadaju sledece dodate kocke; celije se ne mesaju izmedju soba
+    int room = -1;
+
+    void AddCube(const glm::mat4& M, const glm::vec4& tint, bool cull = true);
+    void AddTexturedCube(const glm::mat4& M, TextureHandle tex, const glm::vec4& tint = glm::vec4(1.0f), bool cull = true);
+    // Kocka u baseTint i tekstura na jednoj stranici, malo izvucena (lift) da ne bi bilo z-fight-a
+    void AddTexturedCubeFace(const glm::mat4& M, TextureHandle tex, const glm::vec4& baseTint, const glm::vec4& faceTint,
+                             CubeFace face, float lift = 0.001f, bool cull = true);
+
+    // Pravi GL bafere i oslobadja CPU kopiju
+    void Build(Renderer& R);
+    void Draw(Renderer& R, bool cullOn);
+    void Destroy(Renderer& R);
+
+private:
+    struct Group {
+        bool cull = true;
+        int room = -1;
+        glm::ivec2 cell {0};
+        TextureHandle tex;
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    struct Cell {
+        bool cull = true;
+        int room = -1;
+        MeshGL mesh;
+    };
+
+    static glm::ivec2 CellOf(const glm::mat4& M);
+    Group& GetGroup(bool cull, const glm::ivec2& cell, TextureHandle tex);
+    void AddFaces(Group& g, const glm::mat4& M, const glm::vec4& tint, int firstFace, int faceCount);
+
+    std::vector<Group> groups;
+    std::vector<float> cubeVerts;
+    std::vector<Cell> cells;
+    size_t sourceDraws = 0;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <GL/glew.h>
+
+// Deo bafera dodeljen za jedan upis; offset je u odnosu na pocetak bafera
+struct StreamAlloc {
+    unsigned char* ptr = nullptr;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+
+    bool Valid() const { return ptr != nullptr; }
+};
+
+// Jedan bafer za sve sto se menja svakog frejma: instance kutija i znakova, Frame i Draw blokovi.
+// Podeljen je na tri segmenta (frejm koji se pise i dva koja GPU mozda jos cita); segment se
+// ponovo koristi tek kad prodje njegov fence, pa upis nikad ne ceka implicitnu sinhronizaciju.
+// Sa ARB_buffer_storage bafer je trajno i koherentno mapiran; na 3.3 (macOS 4.1) upis ide u CPU
+// kopiju, Commit salje opseg sa glBufferSubData, a BeginFrame orphan-uje bafer.
+class StreamBuffer {
+public:
+    bool Init(size_t bytesPerFrame, int frameCount = 3);
+    void Destroy();
+
+    // Pocetak frejma: prelazi na sledeci segment i ceka njegov fence ako GPU jos nije gotov
+    void BeginFrame();
+    // Posle poslednjeg poziva koji cita segment
+    void EndFrame();
+
+    // align mora biti stepen dvojke; nevazeci rezultat ako je segment pun (tada se bafer povecava u BeginFrame)
+    StreamAlloc Alloc(size_t bytes, size_t align);
+    // Podaci su upisani u a.ptr; mora pre poziva za crtanje koji ih cita
+    void Commit(const StreamAlloc& a);
+
+    GLuint Buffer() const { return buffer; }
+    bool Persistent() const { return persistent; }
+    void PrintStats() const;
+
+private:
+    void WaitFence(GLsync& fence);
+
+    GLuint buffer = 0;
+    bool persistent = false;
+    unsigned char* mapped = nullptr;         // trajno mapiran ceo bafer
+    std::vector<unsigned char> shadow;       // bez trajnog mapiranja: CPU kopija segmenta
+    size_t frameBytes = 0;
+    std::vector<GLsync> fences;
+    int segment = 0;
+    size_t head = 0;                         // u okviru segmenta
+
+    size_t lastBytes = 0, peakBytes = 0;
+    size_t stalls = 0, overflows = 0;
+    bool grow = false;
+};
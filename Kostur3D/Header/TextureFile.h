@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Header/MappedFile.h"
+
+// Unapred ispecene teksture: KTX (verzija 1) fajl <slika>.ktx pored izvora, pravi ga KosturTexBake.
+// Nivoi su vec blok-kompresovani (BC1 bez alfe, BC3 sa alfom) ili RGBA8, sa celim lancem mipmapa,
+// redovi odozdo nagore kao posle stbi flip-a. Velicina i FNV-1a hes izvora su u kljucu "KosturSource",
+// pa se zastareo fajl odbacuje i ide se na dekodiranje izvora.
+
+// GL konstante su ovde da alat ne bi zavisio od GL zaglavlja
+static constexpr uint32_t TEXFMT_BC1   = 0x83F0; // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+static constexpr uint32_t TEXFMT_BC3   = 0x83F3; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+static constexpr uint32_t TEXFMT_RGBA8 = 0x8058; // GL_RGBA8
+
+struct TextureLevel {
+    const unsigned char* data = nullptr;
+    uint32_t size = 0;
+    int width = 0;
+    int height = 0;
+};
+
+struct TextureFile {
+    uint32_t format = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<TextureLevel> levels;
+    MappedFile file; // prazan kad su podaci u arhivi
+
+    bool Compressed() const { return format == TEXFMT_BC1 || format == TEXFMT_BC3; }
+    size_t Bytes() const;
+};
+
+std::string TextureFilePath(const char* srcPath);
+size_t TextureLevelSize(uint32_t format, int width, int height);
+// Jedan nivo u RGBA8 (BC1/BC3 blokovi se raspakuju na CPU-u); redovi ostaju u istom redosledu
+bool DecodeTextureLevel(uint32_t format, const TextureLevel& level, std::vector<unsigned char>& rgba);
+
+// Arhiva ili disk; false ako fajla nema, ako je ostecen ili ne odgovara izvoru
+bool OpenTextureFile(const char* srcPath, TextureFile& out);
+bool WriteTextureFile(const char* path, uint32_t format, int width, int height,
+                      const std::vector<std::vector<unsigned char>>& levels,
+                      uint64_t srcSize, uint64_t srcHash);
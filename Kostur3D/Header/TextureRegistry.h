@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <GL/glew.h>
+#include "Header/TextureFile.h"
+
+// Indeks slota + generacija; posle oslobadjanja stari handle vise ne vazi
+struct TextureHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool Valid() const { return generation != 0; }
+};
+
+// Jedna GL tekstura po kanonskoj putanji, sa brojem korisnika. Svaka tekstura ima pun lanac
+// mipmapa; filter i wrap su u deljenim sampler objektima (SamplerCache), ne u teksturi.
+// Radi samo na glavnoj niti (GL kontekst); dekodiranje moze biti bilo gde.
+class TextureRegistry {
+public:
+    enum class State { Empty, Queued, Loaded, Failed };
+
+    // Postojeci unos (+1 referenca) ili novi prazan unos koji jos treba ucitati
+    TextureHandle Acquire(const std::string& path);
+    void AddRef(TextureHandle h);
+    // Poslednji Release brise GL teksturu
+    void Release(TextureHandle& h);
+
+    // Sinhrono ucitavanje, ako unos jos nije ucitan; ispeceni .ktx ima prednost nad izvorom
+    TextureHandle Load(const std::string& path);
+    void Upload(TextureHandle h, const unsigned char* pixels, int width, int height);
+    // Blokovi idu direktno u glCompressedTexImage2D; bez podrske za format dekodira se izvor
+    void Upload(TextureHandle h, const TextureFile& file);
+    // GL_TEXTURE_2D_ARRAY: svaki nivo u file ima layers slojeva jedan za drugim (samo RGBA8)
+    void UploadArray(TextureHandle h, const TextureFile& file, int layers);
+    void MarkQueued(TextureHandle h);
+
+    State GetState(TextureHandle h) const;
+    const std::string& Path(TextureHandle h) const;
+    // GL tekstura; dok nije ucitana (ili ako handle ne vazi) bela 1x1
+    GLuint Get(TextureHandle h);
+    GLuint White();
+
+    size_t Count() const { return lookup.size(); }
+    size_t ResidentBytes() const { return residentBytes; }
+    void PrintStats() const;
+
+    // Strimovanje (samo ispecene .ktx teksture, one imaju sve nivoe na disku).
+    // Crtanje prijavljuje koliko piksela na ekranu zauzima objekat sa teksturom; odatle sledi
+    // najvisi mip koji treba da bude u memoriji. Preko budzeta se skidaju najvisi nivoi
+    // najduze nekoriscenih tekstura. 0 = bez budzeta.
+    void SetBudget(size_t bytes) { budgetBytes = bytes; }
+    size_t Budget() const { return budgetBytes; }
+    // Pocetak crtanja frejma (Renderer::Submit); NoteUse posle toga vazi za taj frejm
+    void BeginFrame() { frame++; }
+    void NoteUse(TextureHandle h, float projectedPixels);
+    void NoteUse(GLuint tex, float projectedPixels);
+    // Posle crtanja, kad radne niti miruju: (tekstura, novi najvisi nivo) za poslednji nacrtani frejm
+    void UpdateStreaming(std::vector<std::pair<TextureHandle, int>>& requests);
+    // Glavna nit: zamenjuje GL teksturu nivoima od topLevel nanize (file pocinje od tog nivoa)
+    void Restream(TextureHandle h, const TextureFile& file, int topLevel);
+    void CancelStream(TextureHandle h);
+
+    // Pre gasenja konteksta; sve sto je jos zauzeto se prijavljuje i brise
+    void Clear();
+
+private:
+    struct Entry {
+        std::string path;
+        GLuint tex = 0;
+        int width = 0, height = 0;
+        int layers = 1;
+        size_t bytes = 0;
+        uint32_t format = 0;
+        // Strimovanje: nivo 0 GL teksture je mip topLevel originala
+        int topLevel = 0;
+        int levelCount = 1;
+        int wantedLevel = 0;
+        int pendingLevel = -1;
+        bool streamable = false;
+        uint64_t lastUsed = 0;
+        uint32_t refs = 0;
+        uint32_t generation = 1;
+        State state = State::Empty;
+    };
+
+    void UploadLevels(Entry& e, const TextureFile& file, int topLevel);
+    void Finish(Entry& e, GLenum target = GL_TEXTURE_2D);
+    void NoteUse(Entry& e, float projectedPixels);
+    size_t ChainBytes(const Entry& e, int topLevel) const;
+    Entry* Resolve(TextureHandle h);
+    const Entry* Resolve(TextureHandle h) const;
+
+    std::vector<Entry> entries;
+    std::vector<uint32_t> freeSlots;
+    std::map<std::string, uint32_t> lookup;
+    std::unordered_map<GLuint, uint32_t> byTex;
+    size_t residentBytes = 0;
+    size_t budgetBytes = 0;
+    uint64_t frame = 1;
+    GLuint white = 0;
+};
+
+extern TextureRegistry gTextures;
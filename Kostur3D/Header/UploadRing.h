@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <GL/glew.h>
+
+// Slot u prstenu; ptr je mapirana memorija PBO-a, offset je pozicija slota u vezanom baferu
+struct UploadSlot {
+    int index = -1;
+    unsigned char* ptr = nullptr;
+    size_t offset = 0;
+    size_t size = 0;
+
+    bool Valid() const { return index >= 0; }
+};
+
+// Prsten PBO slotova za asinhroni upload tekstura.
+// Sa ARB_buffer_storage ceo prsten je jedan trajno mapiran bafer; inace (3.3, macOS 4.1) je svaki
+// slot poseban PBO koji ostaje mapiran dok je slobodan, a glavna nit ga odmapira pre kopiranja.
+// Radne niti samo uzimaju slot i pisu u njega; glavna nit zadaje kopiju u teksturu i stavlja fence,
+// a slot je ponovo slobodan tek kad GPU zavrsi citanje.
+class UploadRing {
+public:
+    bool Init(int slotCount = 4, size_t slotBytes = (size_t)16 << 20);
+    void Destroy();
+
+    // Bilo koja nit. false ako nema slobodnog slota ili je zahtev veci od slota - tada ide obican upload.
+    bool TryAcquire(size_t bytes, UploadSlot& out);
+    // Slot koji je uzet ali nece biti poslat
+    void Cancel(UploadSlot& s);
+
+    // Glavna nit: vezuje PBO slota na GL_PIXEL_UNPACK_BUFFER; "pokazivaci" za glTex*Image su offset-i
+    void BeginCopy(const UploadSlot& s);
+    // Glavna nit: odvezuje PBO i stavlja fence
+    void EndCopy(UploadSlot& s);
+
+    // Glavna nit, jednom po frejmu: proverava fence-ove i vraca (i ponovo mapira) zavrsene slotove
+    void Update();
+
+    bool Persistent() const { return persistent; }
+    void PrintStats() const;
+
+private:
+    enum class SlotState { Free, Writing, Copying, InFlight };
+
+    struct Slot {
+        GLuint pbo = 0;
+        size_t offset = 0;
+        unsigned char* ptr = nullptr;
+        GLsync fence = nullptr;
+        SlotState state = SlotState::Free;
+    };
+
+    bool MapSlot(Slot& s);
+
+    std::vector<Slot> slots;
+    size_t slotBytes = 0;
+    bool persistent = false;
+    GLuint buffer = 0;
+
+    std::mutex mutex;
+    std::atomic<uint32_t> acquired {0};
+    std::atomic<uint32_t> rejected {0};
+};
+
+extern UploadRing gUploadRing;
@@ -0,0 +1,91 @@
+#include "Header/AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+AssetArchive gArchive;
+
+std::string NormalizeAssetPath(const char* path)
+{
+    std::string s(path);
+    std::replace(s.begin(), s.end(), '\\', '/');
+    while (s.compare(0, 2, "./") == 0) s.erase(0, 2);
+    return s;
+}
+
+bool AssetArchive::Open(const char* path)
+{
+    Close();
+
+    MappedFile f;
+    if (!f.Open(path)) return false;
+    if (f.Size() < sizeof(ArchiveHeader)) return false;
+
+    ArchiveHeader h;
+    std::memcpy(&h, f.Data(), sizeof(h));
+    if (std::memcmp(h.magic, ARCHIVE_MAGIC, 4) != 0 || h.version != ARCHIVE_VERSION) return false;
+    if (h.tocOffset + (uint64_t)h.entryCount * sizeof(ArchiveEntry) > f.Size()) return false;
+    if (h.namesOffset > f.Size()) return false;
+
+    const ArchiveEntry* toc = (const ArchiveEntry*)(f.Data() + h.tocOffset);
+    size_t namesSize = f.Size() - (size_t)h.namesOffset;
+    for (uint32_t i = 0; i < h.entryCount; i++)
+    {
+        if (toc[i].offset + toc[i].size > f.Size()) return false;
+        if ((uint64_t)toc[i].nameOffset + toc[i].nameLength > namesSize) return false;
+    }
+
+    entries = toc;
+    names = (const char*)(f.Data() + h.namesOffset);
+    entryCount = h.entryCount;
+    file = std::move(f);
+
+    std::cout << "[ARCHIVE] " << path << " | " << entryCount << " entries, " << file.Size() / 1024 << " KB\n";
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    file.Close();
+    entries = nullptr;
+    names = nullptr;
+    entryCount = 0;
+}
+
+const ArchiveEntry* AssetArchive::Find(const char* logicalPath) const
+{
+    if (!entryCount) return nullptr;
+
+    std::string key = NormalizeAssetPath(logicalPath);
+    uint64_t hash = Fnv1a64(key.data(), key.size());
+
+    const ArchiveEntry* end = entries + entryCount;
+    const ArchiveEntry* it = std::lower_bound(entries, end, hash,
+        [](const ArchiveEntry& e, uint64_t h) { return e.pathHash < h; });
+
+    for (; it != end && it->pathHash == hash; ++it)
+        if (it->nameLength == key.size() && std::memcmp(names + it->nameOffset, key.data(), key.size()) == 0)
+            return it;
+    return nullptr;
+}
+
+bool ReadAsset(const char* path, std::string& out)
+{
+    if (const ArchiveEntry* e = gArchive.Find(path))
+    {
+        out.assign((const char*)gArchive.Data(*e), (size_t)e->size);
+        return true;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool AssetArchive::Contains(const void* p) const
+{
+    const unsigned char* b = (const unsigned char*)p;
+    return file.IsOpen() && b >= file.Data() && b < file.Data() + file.Size();
+}
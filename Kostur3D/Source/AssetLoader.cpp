@@ -0,0 +1,534 @@
+#include "Header/AssetLoader.h"
+#include "Header/MeshCache.h"
+#include "Util.h"
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+AssetLoader::AssetLoader(unsigned threads)
+{
+    if (threads == 0)
+    {
+        unsigned hw = std::thread::hardware_concurrency();
+        threads = hw > 1 ? hw - 1 : 1;
+    }
+    threadCount = threads;
+}
+
+AssetLoader::~AssetLoader()
+{
+    nextJob = jobs.size();
+    for (auto& t : workers)
+        if (t.joinable()) t.join();
+
+    for (auto& job : jobs)
+    {
+        ReleaseImage(job->image);
+        for (auto& kv : job->objTextures)
+            ReleaseImage(kv.second);
+    }
+}
+
+void AssetLoader::Push(std::unique_ptr<Job> job)
+{
+    // Radne niti citaju jobs bez zakljucavanja, pa novi zahtevi cekaju sledeci Start
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pending.push_back(std::move(job));
+}
+
+void AssetLoader::TakePending()
+{
+    assert(workers.empty());
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    for (auto& job : pending)
+        jobs.push_back(std::move(job));
+    pending.clear();
+}
+
+bool AssetLoader::Done() const
+{
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    return pending.empty() && uploaded == jobs.size();
+}
+
+TextureHandle AssetLoader::RequestTexture(const std::string& path)
+{
+    TextureHandle h = gTextures.Acquire(path);
+    if (gTextures.GetState(h) != TextureRegistry::State::Empty)
+        return h;
+
+    gTextures.MarkQueued(h);
+
+    auto job = std::make_unique<Job>();
+    job->kind = Job::Kind::Texture;
+    job->path = path;
+    job->tex = h;
+    Push(std::move(job));
+    return h;
+}
+
+TextureHandle AssetLoader::RequestTextureArray(const std::string& name, const std::vector<std::string>& layerPaths,
+                                              int layerSize)
+{
+    TextureHandle h = gTextures.Acquire(name);
+    if (gTextures.GetState(h) != TextureRegistry::State::Empty)
+        return h;
+
+    gTextures.MarkQueued(h);
+
+    auto job = std::make_unique<Job>();
+    job->kind = Job::Kind::TextureArray;
+    job->path = name;
+    job->tex = h;
+    job->layerPaths = layerPaths;
+    job->layerSize = layerSize;
+    Push(std::move(job));
+    return h;
+}
+
+void AssetLoader::RequestTextureLevel(TextureHandle h, int level)
+{
+    // Referenca drzi unos zivim dok posao ne zavrsi
+    gTextures.AddRef(h);
+
+    auto job = std::make_unique<Job>();
+    job->kind = Job::Kind::TextureLevels;
+    job->path = gTextures.Path(h);
+    job->tex = h;
+    job->level = level;
+    Push(std::move(job));
+}
+
+void AssetLoader::SetMeshPlaceholder(Job& job)
+{
+    MeshGL& m = *job.meshTarget;
+    glm::vec3 bmin, bmax;
+    *job.okTarget = PeekMeshCacheBounds(job.path.c_str(), job.color, bmin, bmax);
+    if (*job.okTarget) SetMeshBounds(m, bmin, bmax);
+    m.isPlaceholder = *job.okTarget;
+}
+
+void AssetLoader::RequestMesh(const std::string& objPath, const glm::vec4& color, MeshGL* target, bool* ok,
+                              VertexFormat format)
+{
+    auto job = std::make_unique<Job>();
+    job->kind = Job::Kind::Mesh;
+    job->path = objPath;
+    job->color = color;
+    job->format = format;
+    job->meshTarget = target;
+    job->okTarget = ok;
+    SetMeshPlaceholder(*job);
+    Push(std::move(job));
+}
+
+void AssetLoader::RequestSubMeshes(const std::string& objPath, const glm::vec4& color, MeshGL* target, bool* ok,
+                                   const std::vector<std::string>& onlyMaterials,
+                                   VertexFormat format)
+{
+    auto job = std::make_unique<Job>();
+    job->kind = Job::Kind::SubMeshes;
+    job->path = objPath;
+    job->color = color;
+    job->format = format;
+    job->onlyMaterials = onlyMaterials;
+    job->meshTarget = target;
+    job->okTarget = ok;
+    SetMeshPlaceholder(*job);
+    Push(std::move(job));
+}
+
+void AssetLoader::Start()
+{
+    if (!workers.empty()) return;
+    TakePending();
+
+    size_t n = std::min<size_t>(threadCount, jobs.size());
+    for (size_t i = 0; i < n; i++)
+        workers.emplace_back(&AssetLoader::WorkerMain, this);
+}
+
+void AssetLoader::LoadImage(const std::string& path, Image& img)
+{
+    if (!OpenTextureFile(path.c_str(), img.file))
+        img.pixels = decodeImage(path.c_str(), &img.w, &img.h);
+    StageImage(img);
+}
+
+// Bilinearno preskaliranje RGBA8 slike na size x size
+static void ResampleRGBA(const unsigned char* src, int w, int h, unsigned char* dst, int size)
+{
+    for (int y = 0; y < size; y++)
+    {
+        float sy = std::max(0.0f, (y + 0.5f) * h / size - 0.5f);
+        int y0 = std::min((int)sy, h - 1);
+        int y1 = std::min(y0 + 1, h - 1);
+        float fy = sy - y0;
+
+        for (int x = 0; x < size; x++)
+        {
+            float sx = std::max(0.0f, (x + 0.5f) * w / size - 0.5f);
+            int x0 = std::min((int)sx, w - 1);
+            int x1 = std::min(x0 + 1, w - 1);
+            float fx = sx - x0;
+
+            const unsigned char* p00 = src + ((size_t)y0 * w + x0) * 4;
+            const unsigned char* p10 = src + ((size_t)y0 * w + x1) * 4;
+            const unsigned char* p01 = src + ((size_t)y1 * w + x0) * 4;
+            const unsigned char* p11 = src + ((size_t)y1 * w + x1) * 4;
+            unsigned char* d = dst + ((size_t)y * size + x) * 4;
+
+            for (int c = 0; c < 4; c++)
+            {
+                float top = p00[c] + (p10[c] - p00[c]) * fx;
+                float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+                d[c] = (unsigned char)std::lround(top + (bottom - top) * fy);
+            }
+        }
+    }
+}
+
+// 2x2 box filter kvadratnog RGBA8 sloja; kod neparne velicine poslednja kolona/red se ponavlja
+static void DownsampleRGBA(const unsigned char* src, int srcSize, unsigned char* dst, int dstSize)
+{
+    for (int y = 0; y < dstSize; y++)
+    {
+        int y0 = std::min(y * 2, srcSize - 1), y1 = std::min(y * 2 + 1, srcSize - 1);
+        for (int x = 0; x < dstSize; x++)
+        {
+            int x0 = std::min(x * 2, srcSize - 1), x1 = std::min(x * 2 + 1, srcSize - 1);
+            for (int c = 0; c < 4; c++)
+            {
+                int sum = src[((size_t)y0 * srcSize + x0) * 4 + c] + src[((size_t)y0 * srcSize + x1) * 4 + c]
+                        + src[((size_t)y1 * srcSize + x0) * 4 + c] + src[((size_t)y1 * srcSize + x1) * 4 + c];
+                dst[((size_t)y * dstSize + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+// Ispecen .ktx ima prednost: raspakuje se samo najmanji nivo koji jos pokriva sloj
+static bool LoadLayer(const std::string& path, int size, unsigned char* dst)
+{
+    TextureFile file;
+    if (OpenTextureFile(path.c_str(), file))
+    {
+        size_t pick = 0;
+        while (pick + 1 < file.levels.size() && file.levels[pick + 1].width >= size && file.levels[pick + 1].height >= size)
+            pick++;
+
+        std::vector<unsigned char> rgba;
+        const TextureLevel& l = file.levels[pick];
+        if (DecodeTextureLevel(file.format, l, rgba))
+        {
+            ResampleRGBA(rgba.data(), l.width, l.height, dst, size);
+            return true;
+        }
+    }
+
+    int w = 0, h = 0;
+    unsigned char* pixels = decodeImage(path.c_str(), &w, &h);
+    if (!pixels) return false;
+    ResampleRGBA(pixels, w, h, dst, size);
+    freeImage(pixels);
+    return true;
+}
+
+bool AssetLoader::LoadImageArray(const std::vector<std::string>& paths, int size, std::vector<unsigned char>& storage, Image& img)
+{
+    size_t layers = paths.size();
+    std::vector<size_t> offsets;
+    size_t total = 0;
+    for (int s = size; ; s /= 2)
+    {
+        offsets.push_back(total);
+        total += (size_t)s * s * 4 * layers;
+        if (s <= 1) break;
+    }
+    storage.assign(total, 0);
+
+    bool ok = true;
+    for (size_t i = 0; i < layers; i++)
+        if (!LoadLayer(paths[i], size, &storage[i * size * size * 4])) ok = false;
+
+    TextureFile& file = img.file;
+    file.format = TEXFMT_RGBA8;
+    file.width = size;
+    file.height = size;
+    file.levels.clear();
+    for (size_t k = 0; k < offsets.size(); k++)
+    {
+        int s = std::max(1, size >> k);
+        if (k > 0)
+        {
+            int ps = std::max(1, size >> (k - 1));
+            for (size_t i = 0; i < layers; i++)
+                DownsampleRGBA(&storage[offsets[k - 1] + i * ps * ps * 4], ps, &storage[offsets[k] + i * s * s * 4], s);
+        }
+        file.levels.push_back({ &storage[offsets[k]], (uint32_t)((size_t)s * s * 4 * layers), s, s });
+    }
+
+    StageImage(img);
+    return ok;
+}
+
+void AssetLoader::StageImage(Image& img)
+{
+    TextureFile src;
+    if (img.pixels)
+    {
+        src.format = TEXFMT_RGBA8;
+        src.width = img.w;
+        src.height = img.h;
+        src.levels.push_back({ img.pixels, (uint32_t)((size_t)img.w * img.h * 4), img.w, img.h });
+    }
+    else
+    {
+        src.format = img.file.format;
+        src.width = img.file.width;
+        src.height = img.file.height;
+        src.levels = img.file.levels;
+    }
+    if (src.levels.empty()) return;
+
+    auto align = [](size_t n) { return (n + 15) & ~(size_t)15; };
+    size_t total = 0;
+    for (const TextureLevel& l : src.levels) total += align(l.size);
+
+    // Nema slobodnog slota (ili je slika veca od slota) - ostaje upload iz CPU memorije
+    if (!gUploadRing.TryAcquire(total, img.slot)) return;
+
+    size_t pos = 0;
+    for (TextureLevel& l : src.levels)
+    {
+        std::memcpy(img.slot.ptr + pos, l.data, l.size);
+        l.data = (const unsigned char*)(uintptr_t)(img.slot.offset + pos);
+        pos += align(l.size);
+    }
+
+    if (img.pixels) freeImage(img.pixels);
+    img.pixels = nullptr;
+    img.file = std::move(src);
+}
+
+void AssetLoader::ReleaseImage(Image& img)
+{
+    if (img.pixels) freeImage(img.pixels);
+    img.pixels = nullptr;
+    if (img.slot.Valid()) gUploadRing.Cancel(img.slot);
+    img.file = TextureFile();
+}
+
+void AssetLoader::UploadImage(TextureHandle h, Image& img)
+{
+    if (img.slot.Valid())
+    {
+        gUploadRing.BeginCopy(img.slot);
+        gTextures.Upload(h, img.file);
+        gUploadRing.EndCopy(img.slot);
+    }
+    else if (!img.file.levels.empty())
+        gTextures.Upload(h, img.file);
+    else
+        gTextures.Upload(h, img.pixels, img.w, img.h);
+
+    ReleaseImage(img);
+}
+
+void AssetLoader::WorkerMain()
+{
+    for (;;)
+    {
+        size_t i = nextJob.fetch_add(1);
+        if (i >= jobs.size()) return;
+
+        Job& job = *jobs[i];
+        Run(job);
+
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            ready.push_back(&job);
+        }
+        readyCv.notify_one();
+    }
+}
+
+void AssetLoader::Run(Job& job)
+{
+    switch (job.kind)
+    {
+    case Job::Kind::Texture:
+        LoadImage(job.path, job.image);
+        job.ok = !job.image.file.levels.empty() || job.image.pixels != nullptr;
+        break;
+
+    case Job::Kind::TextureLevels:
+        // Mapira se ceo fajl, ali se citaju samo stranice trazenih nivoa
+        job.ok = OpenTextureFile(job.path.c_str(), job.image.file) && job.level < (int)job.image.file.levels.size();
+        if (job.ok)
+        {
+            auto& levels = job.image.file.levels;
+            levels.erase(levels.begin(), levels.begin() + job.level);
+            StageImage(job.image);
+        }
+        break;
+
+    case Job::Kind::TextureArray:
+        job.ok = LoadImageArray(job.layerPaths, job.layerSize, job.layerPixels, job.image);
+        break;
+
+    case Job::Kind::Mesh:
+        job.ok = LoadObjPayload(job.path.c_str(), job.color, job.obj);
+        break;
+
+    case Job::Kind::SubMeshes:
+        job.ok = LoadObjPayload(job.path.c_str(), job.color, job.obj);
+        if (job.ok)
+        {
+            for (const std::string& texPath : ObjDiffuseTextures(job.obj, job.onlyMaterials))
+            {
+                LoadImage(texPath, job.objTextures[texPath]);
+            }
+        }
+        break;
+    }
+}
+
+void AssetLoader::Upload(Job& job, Renderer& R)
+{
+    switch (job.kind)
+    {
+    case Job::Kind::Texture:
+        UploadImage(job.tex, job.image);
+        break;
+
+    case Job::Kind::TextureLevels:
+        if (!job.ok)
+            gTextures.CancelStream(job.tex);
+        else if (job.image.slot.Valid())
+        {
+            gUploadRing.BeginCopy(job.image.slot);
+            gTextures.Restream(job.tex, job.image.file, job.level);
+            gUploadRing.EndCopy(job.image.slot);
+        }
+        else
+            gTextures.Restream(job.tex, job.image.file, job.level);
+        ReleaseImage(job.image);
+        gTextures.Release(job.tex);
+        break;
+
+    case Job::Kind::TextureArray:
+        if (!job.ok)
+            std::cout << "[TEX] " << job.path << " | neki slojevi nisu ucitani\n";
+        if (job.image.slot.Valid())
+        {
+            gUploadRing.BeginCopy(job.image.slot);
+            gTextures.UploadArray(job.tex, job.image.file, (int)job.layerPaths.size());
+            gUploadRing.EndCopy(job.image.slot);
+        }
+        else
+            gTextures.UploadArray(job.tex, job.image.file, (int)job.layerPaths.size());
+        ReleaseImage(job.image);
+        job.layerPixels = std::vector<unsigned char>();
+        break;
+
+    case Job::Kind::Mesh:
+        if (job.ok) UploadObjMesh(job.obj, R, *job.meshTarget, job.format);
+        else job.meshTarget->isPlaceholder = false;
+        *job.okTarget = job.ok;
+        break;
+
+    case Job::Kind::SubMeshes:
+        if (job.ok)
+        {
+            auto textureFor = [&](const std::string& path) -> TextureHandle
+            {
+                TextureHandle h = gTextures.Acquire(path);
+                auto img = job.objTextures.find(path);
+                if (img != job.objTextures.end())
+                    UploadImage(h, img->second);
+                return h;
+            };
+            job.ok = UploadObjSubMeshes(job.obj, R, *job.meshTarget, job.onlyMaterials, textureFor, job.format);
+        }
+        if (!job.ok) job.meshTarget->isPlaceholder = false;
+        *job.okTarget = job.ok;
+
+        for (auto& kv : job.objTextures)
+            ReleaseImage(kv.second);
+        job.objTextures.clear();
+        break;
+    }
+
+    // CPU kopija (ili mapirani kes) vise nije potrebna
+    job.obj = ObjPayload();
+    uploaded++;
+}
+
+size_t AssetLoader::Pump(Renderer& R, double budgetSeconds)
+{
+    auto start = std::chrono::steady_clock::now();
+    size_t count = 0;
+
+    gUploadRing.Update();
+    // Novi poslovi samo dok nijedna radna nit ne cita jobs; nivoi se racunaju iz prethodnog frejma
+    if (workers.empty())
+    {
+        streamRequests.clear();
+        gTextures.UpdateStreaming(streamRequests);
+        for (const auto& r : streamRequests)
+            RequestTextureLevel(r.first, r.second);
+    }
+    // Zahtevi posle pocetnog ucitavanja (strimovanje, zamena teksture u toku rada)
+    Start();
+
+    for (;;)
+    {
+        Job* job = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            if (ready.empty()) break;
+            job = ready.front();
+            ready.pop_front();
+        }
+
+        Upload(*job, R);
+        count++;
+
+        // Ostatak ide u sledeci frejm, da upload ne napravi trzaj
+        if (budgetSeconds > 0.0)
+        {
+            std::chrono::duration<double> spent = std::chrono::steady_clock::now() - start;
+            if (spent.count() >= budgetSeconds) break;
+        }
+    }
+
+    if (uploaded == jobs.size() && !workers.empty())
+    {
+        for (auto& t : workers)
+            t.join();
+        workers.clear();
+        // Sve je uploadovano; strimovanje inace gomila zavrsene poslove
+        jobs.clear();
+        nextJob = 0;
+        uploaded = 0;
+    }
+    return count;
+}
+
+void AssetLoader::Finish(Renderer& R)
+{
+    for (;;)
+    {
+        // Zahtevi stigli dok su niti radile krecu tek kad se niti zavrse
+        Start();
+        if (Done()) break;
+        {
+            std::unique_lock<std::mutex> lock(readyMutex);
+            readyCv.wait(lock, [&]{ return !ready.empty(); });
+        }
+        Pump(R);
+    }
+}
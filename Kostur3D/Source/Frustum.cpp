@@ -0,0 +1,110 @@
+#include "Header/Frustum.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FRUSTUM_NEON 1
+#endif
+
+Frustum ExtractFrustum(const glm::mat4& VP)
+{
+    // Redovi matrice (glm je po kolonama)
+    glm::vec4 r0(VP[0][0], VP[1][0], VP[2][0], VP[3][0]);
+    glm::vec4 r1(VP[0][1], VP[1][1], VP[2][1], VP[3][1]);
+    glm::vec4 r2(VP[0][2], VP[1][2], VP[2][2], VP[3][2]);
+    glm::vec4 r3(VP[0][3], VP[1][3], VP[2][3], VP[3][3]);
+
+    Frustum f;
+    f.planes[0] = r3 + r0;
+    f.planes[1] = r3 - r0;
+    f.planes[2] = r3 + r1;
+    f.planes[3] = r3 - r1;
+    f.planes[4] = r3 + r2;
+    f.planes[5] = r3 - r2;
+
+    for (glm::vec4& p : f.planes)
+    {
+        float len = glm::length(glm::vec3(p));
+        if (len > 0.0f) p /= len;
+    }
+    return f;
+}
+
+bool SphereInFrustum(const Frustum& f, const glm::vec3& c, float radius)
+{
+    for (const glm::vec4& p : f.planes)
+        if (p.x * c.x + p.y * c.y + p.z * c.z + p.w < -radius)
+            return false;
+    return true;
+}
+
+bool BoxInFrustum(const Frustum& f, const glm::vec3& c, const glm::vec3& e)
+{
+    for (const glm::vec4& p : f.planes)
+    {
+        // Projekcija kutije na normalu ravni
+        float r = e.x * std::fabs(p.x) + e.y * std::fabs(p.y) + e.z * std::fabs(p.z);
+        if (p.x * c.x + p.y * c.y + p.z * c.z + p.w < -r)
+            return false;
+    }
+    return true;
+}
+
+void CullSpheres(const Frustum& f, const float* x, const float* y, const float* z, const float* radius,
+                 size_t count, uint8_t* visible)
+{
+    size_t i = 0;
+
+#if defined(FRUSTUM_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(x + i);
+        __m128 cy = _mm_loadu_ps(y + i);
+        __m128 cz = _mm_loadu_ps(z + i);
+        __m128 nr = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+        // Bit po sferi ostaje 1 dok je sfera sa unutrasnje strane svih ravni
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const glm::vec4& p : f.planes)
+        {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(p.x)), _mm_mul_ps(cy, _mm_set1_ps(p.y))),
+                                  _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(p.z)), _mm_set1_ps(p.w)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, nr));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; k++)
+            visible[i + k] = (uint8_t)((mask >> k) & 1);
+    }
+#elif defined(FRUSTUM_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t cx = vld1q_f32(x + i);
+        float32x4_t cy = vld1q_f32(y + i);
+        float32x4_t cz = vld1q_f32(z + i);
+        float32x4_t nr = vnegq_f32(vld1q_f32(radius + i));
+
+        uint32x4_t inside = vdupq_n_u32(~0u);
+        for (const glm::vec4& p : f.planes)
+        {
+            float32x4_t d = vdupq_n_f32(p.w);
+            d = vmlaq_n_f32(d, cx, p.x);
+            d = vmlaq_n_f32(d, cy, p.y);
+            d = vmlaq_n_f32(d, cz, p.z);
+            inside = vandq_u32(inside, vcgeq_f32(d, nr));
+        }
+
+        uint32_t lanes[4];
+        vst1q_u32(lanes, inside);
+        for (int k = 0; k < 4; k++)
+            visible[i + k] = lanes[k] ? 1 : 0;
+    }
+#endif
+
+    // Ostatak (ili sve, bez SIMD-a)
+    for (; i < count; i++)
+        visible[i] = SphereInFrustum(f, glm::vec3(x[i], y[i], z[i]), radius[i]) ? 1 : 0;
+}
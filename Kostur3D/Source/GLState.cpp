@@ -0,0 +1,230 @@
+#include "Header/GLState.h"
+#include <iostream>
+
+GLStateCache gGLState;
+
+bool GLStateCache::Changed(bool changed)
+{
+    if (changed) issued++;
+    else elided++;
+    return changed;
+}
+
+void GLStateCache::UseProgram(GLuint p)
+{
+    if (!Changed(program != p)) return;
+    program = p;
+    glUseProgram(p);
+}
+
+void GLStateCache::BindVertexArray(GLuint v)
+{
+    if (!Changed(vao != v)) return;
+    vao = v;
+    glBindVertexArray(v);
+}
+
+void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint tex)
+{
+    if (unit < (GLuint)MAX_UNITS && textures[unit] == tex && textureTargets[unit] == target)
+    {
+        Changed(false);
+        return;
+    }
+
+    if (Changed(activeUnit != unit))
+    {
+        activeUnit = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    Changed(true);
+    glBindTexture(target, tex);
+
+    if (unit < (GLuint)MAX_UNITS)
+    {
+        textures[unit] = tex;
+        textureTargets[unit] = target;
+    }
+}
+
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+    GLuint* slot = nullptr;
+    if (target == GL_ARRAY_BUFFER) slot = &arrayBuffer;
+    else if (target == GL_UNIFORM_BUFFER) slot = &uniformBuffer;
+
+    if (slot && !Changed(*slot != buffer)) return;
+    if (!slot) issued++;
+    else *slot = buffer;
+    glBindBuffer(target, buffer);
+}
+
+void GLStateCache::BindUniformBase(GLuint index, GLuint buffer)
+{
+    if (index < (GLuint)MAX_UNIFORM_BINDINGS)
+    {
+        UniformRange& r = uniformRanges[index];
+        // size 0 oznacava ceo bafer
+        if (!Changed(r.buffer != buffer || r.offset != 0 || r.size != 0)) return;
+        r = { buffer, 0, 0 };
+    }
+    else
+        issued++;
+
+    // Menja i opste vezivanje GL_UNIFORM_BUFFER
+    uniformBuffer = buffer;
+    glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+}
+
+void GLStateCache::BindUniformRange(GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    if (index < (GLuint)MAX_UNIFORM_BINDINGS)
+    {
+        UniformRange& r = uniformRanges[index];
+        if (!Changed(r.buffer != buffer || r.offset != offset || r.size != size)) return;
+        r = { buffer, offset, size };
+    }
+    else
+        issued++;
+
+    uniformBuffer = buffer;
+    glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+}
+
+void GLStateCache::Enable(GLenum cap, bool on)
+{
+    int i = -1;
+    switch (cap)
+    {
+    case GL_BLEND:               i = CAP_BLEND; break;
+    case GL_DEPTH_TEST:          i = CAP_DEPTH; break;
+    case GL_CULL_FACE:           i = CAP_CULL; break;
+    case GL_POLYGON_OFFSET_FILL: i = CAP_OFFSET; break;
+    default: break;
+    }
+
+    if (i >= 0)
+    {
+        if (!Changed(caps[i] != (on ? 1 : 0))) return;
+        caps[i] = on ? 1 : 0;
+    }
+    else
+        issued++;
+
+    on ? glEnable(cap) : glDisable(cap);
+}
+
+void GLStateCache::BlendFunc(GLenum src, GLenum dst)
+{
+    if (!Changed(blendSrc != src || blendDst != dst)) return;
+    blendSrc = src;
+    blendDst = dst;
+    glBlendFunc(src, dst);
+}
+
+void GLStateCache::DepthMask(bool on)
+{
+    if (!Changed(depthMask != (on ? 1 : 0))) return;
+    depthMask = on ? 1 : 0;
+    glDepthMask(on ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::ColorMask(bool on)
+{
+    if (!Changed(colorMask != (on ? 1 : 0))) return;
+    colorMask = on ? 1 : 0;
+    GLboolean b = on ? GL_TRUE : GL_FALSE;
+    glColorMask(b, b, b, b);
+}
+
+void GLStateCache::PolygonOffset(float factor, float units)
+{
+    if (!Changed(!offsetKnown || offsetFactor != factor || offsetUnits != units)) return;
+    offsetKnown = true;
+    offsetFactor = factor;
+    offsetUnits = units;
+    glPolygonOffset(factor, units);
+}
+
+void GLStateCache::Uniform1i(GLint location, GLint value)
+{
+    if (location < 0) return;
+
+    for (UniformValue& u : uniforms)
+    {
+        if (u.program != program || u.location != location) continue;
+        if (!Changed(u.value != value)) return;
+        u.value = value;
+        glUniform1i(location, value);
+        return;
+    }
+
+    Changed(true);
+    uniforms.push_back({ program, location, value });
+    glUniform1i(location, value);
+}
+
+void GLStateCache::DeleteVertexArray(GLuint& v)
+{
+    if (!v) return;
+    glDeleteVertexArrays(1, &v);
+    if (vao == v) vao = 0;
+    v = 0;
+}
+
+void GLStateCache::DeleteBuffer(GLuint& b)
+{
+    if (!b) return;
+    glDeleteBuffers(1, &b);
+    if (arrayBuffer == b) arrayBuffer = 0;
+    if (uniformBuffer == b) uniformBuffer = 0;
+    for (UniformRange& r : uniformRanges)
+        if (r.buffer == b) r = { 0, 0, 0 };
+    b = 0;
+}
+
+void GLStateCache::InvalidateBindings()
+{
+    vao = UNKNOWN;
+    activeUnit = UNKNOWN;
+    for (int i = 0; i < MAX_UNITS; i++)
+    {
+        textures[i] = UNKNOWN;
+        textureTargets[i] = 0;
+    }
+    arrayBuffer = UNKNOWN;
+    uniformBuffer = UNKNOWN;
+    for (UniformRange& r : uniformRanges)
+        r = UniformRange();
+}
+
+void GLStateCache::BeginFrame()
+{
+    lastIssued = issued;
+    lastElided = elided;
+    issued = 0;
+    elided = 0;
+    InvalidateBindings();
+}
+
+void GLStateCache::Invalidate()
+{
+    InvalidateBindings();
+    program = UNKNOWN;
+    for (int& c : caps) c = -1;
+    blendSrc = 0;
+    blendDst = 0;
+    depthMask = -1;
+    colorMask = -1;
+    offsetKnown = false;
+    uniforms.clear();
+}
+
+void GLStateCache::PrintStats() const
+{
+    size_t total = lastIssued + lastElided;
+    std::cout << "[GLSTATE] promena stanja " << total << ", poslato " << lastIssued
+              << ", preskoceno " << lastElided;
+    if (total > 0) std::cout << " (" << (100 * lastElided / total) << "%)";
+    std::cout << "\n";
+}
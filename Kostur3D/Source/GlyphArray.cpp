@@ -0,0 +1,86 @@
+#include "Header/GlyphArray.h"
+#include "Header/GLState.h"
+#include <cstddef>
+#include <cstring>
+
+void GlyphArray::Init(TextureHandle tex)
+{
+    Destroy();
+    texture = tex;
+
+    // Isti raspored kao ekranski kvad u Renderer-u (12 float-ova po verteksu)
+    const float quad[6 * 12] = {
+        -0.5f,  0.5f, 0.0f,  1, 1, 1, 1,  0, 1,  0, 0, 1,
+         0.5f,  0.5f, 0.0f,  1, 1, 1, 1,  1, 1,  0, 0, 1,
+         0.5f, -0.5f, 0.0f,  1, 1, 1, 1,  1, 0,  0, 0, 1,
+        -0.5f,  0.5f, 0.0f,  1, 1, 1, 1,  0, 1,  0, 0, 1,
+         0.5f, -0.5f, 0.0f,  1, 1, 1, 1,  1, 0,  0, 0, 1,
+        -0.5f, -0.5f, 0.0f,  1, 1, 1, 1,  0, 0,  0, 0, 1,
+    };
+    const GLsizei stride = 12 * sizeof(float);
+
+    glGenVertexArrays(1, &vao);
+    gGLState.BindVertexArray(vao);
+
+    glGenBuffers(1, &quadVbo);
+    gGLState.BindBuffer(GL_ARRAY_BUFFER, quadVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(7 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(9 * sizeof(float)));
+    glEnableVertexAttribArray(3);
+
+    // Pokazivaci instanci se postavljaju u Upload, na opseg frejma u stream baferu
+    for (GLuint loc = 4; loc <= 6; loc++)
+    {
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+
+    gGLState.BindVertexArray(0);
+}
+
+void GlyphArray::Destroy()
+{
+    gTextures.Release(texture);
+    gGLState.DeleteVertexArray(vao);
+    gGLState.DeleteBuffer(quadVbo);
+    instances.clear();
+}
+
+void GlyphArray::Add(const glm::vec3& center, const glm::vec2& size, int layer, const glm::vec4& tint)
+{
+    GlyphInstance g{};
+    g.pos[0] = center.x; g.pos[1] = center.y; g.pos[2] = center.z;
+    g.layer = (float)layer;
+    g.size[0] = size.x; g.size[1] = size.y;
+    g.tint[0] = tint.r; g.tint[1] = tint.g; g.tint[2] = tint.b; g.tint[3] = tint.a;
+    instances.push_back(g);
+}
+
+GLsizei GlyphArray::Upload(StreamBuffer& stream)
+{
+    GLsizei n = (GLsizei)instances.size();
+    if (n == 0 || !vao) return 0;
+
+    size_t bytes = (size_t)n * sizeof(GlyphInstance);
+    StreamAlloc a = stream.Alloc(bytes, 16);
+    if (!a.Valid()) return 0;
+    std::memcpy(a.ptr, instances.data(), bytes);
+    stream.Commit(a);
+
+    // Zove se iz Renderer::Submit, pa vezivanja idu kroz senku stanja
+    gGLState.BindVertexArray(vao);
+    gGLState.BindBuffer(GL_ARRAY_BUFFER, stream.Buffer());
+    const GLsizei istride = sizeof(GlyphInstance);
+    const size_t base = (size_t)a.offset;
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, istride, (void*)(base + offsetof(GlyphInstance, pos)));
+    glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, istride, (void*)(base + offsetof(GlyphInstance, size)));
+    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, istride, (void*)(base + offsetof(GlyphInstance, tint)));
+    return n;
+}
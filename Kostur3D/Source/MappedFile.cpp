@@ -0,0 +1,105 @@
+#include "Header/MappedFile.h"
+#include <utility>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool StatFile(const char* path, FileStamp& out)
+{
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(path, &st) != 0) return false;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+#endif
+    out.size = (uint64_t)st.st_size;
+    out.mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& o) noexcept
+{
+    *this = std::move(o);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& o) noexcept
+{
+    if (this == &o) return *this;
+    Close();
+    std::swap(data, o.data);
+    std::swap(size, o.size);
+#ifdef _WIN32
+    std::swap(file, o.file);
+    std::swap(mapping, o.mapping);
+#endif
+    return *this;
+}
+
+bool MappedFile::Open(const char* path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER len;
+    if (!GetFileSizeEx(f, &len) || len.QuadPart == 0) { CloseHandle(f); return false; }
+
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) { CloseHandle(f); return false; }
+
+    void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!p) { CloseHandle(m); CloseHandle(f); return false; }
+
+    file = f;
+    mapping = m;
+    data = (const unsigned char*)p;
+    size = (size_t)len.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+
+    data = (const unsigned char*)p;
+    size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (!data) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)mapping);
+    CloseHandle((HANDLE)file);
+    file = nullptr;
+    mapping = nullptr;
+#else
+    munmap((void*)data, size);
+#endif
+    data = nullptr;
+    size = 0;
+}
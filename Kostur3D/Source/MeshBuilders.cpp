@@ -102,3 +102,47 @@ void BuildSphere(std::vector<float>& out,
         }
     }
 }
+
+static const float CUBE_VERTS[] =
+{
+    // Front
+     0.1f, 0.1f, 0.1f,  1,1,1,1,  0,0,   0,0, 1,
+    -0.1f, 0.1f, 0.1f,  1,1,1,1,  1,0,   0,0, 1,
+    -0.1f,-0.1f, 0.1f,  1,1,1,1,  1,1,   0,0, 1,
+     0.1f,-0.1f, 0.1f,  1,1,1,1,  0,1,   0,0, 1,
+
+    // Left
+    -0.1f, 0.1f, 0.1f,  1,1,1,1,  0,0,  -1,0,0,
+    -0.1f, 0.1f,-0.1f,  1,1,1,1,  1,0,  -1,0,0,
+    -0.1f,-0.1f,-0.1f,  1,1,1,1,  1,1,  -1,0,0,
+    -0.1f,-0.1f, 0.1f,  1,1,1,1,  0,1,  -1,0,0,
+
+    // Bottom
+     0.1f,-0.1f, 0.1f,  1,1,1,1,  0,0,   0,-1,0,
+    -0.1f,-0.1f, 0.1f,  1,1,1,1,  1,0,   0,-1,0,
+    -0.1f,-0.1f,-0.1f,  1,1,1,1,  1,1,   0,-1,0,
+     0.1f,-0.1f,-0.1f,  1,1,1,1,  0,1,   0,-1,0,
+
+    // Top
+     0.1f, 0.1f, 0.1f,  1,1,1,1,  0,0,   0,1,0,
+     0.1f, 0.1f,-0.1f,  1,1,1,1,  1,0,   0,1,0,
+    -0.1f, 0.1f,-0.1f,  1,1,1,1,  1,1,   0,1,0,
+    -0.1f, 0.1f, 0.1f,  1,1,1,1,  0,1,   0,1,0,
+
+    // Right
+     0.1f, 0.1f, 0.1f,  1,1,1,1,  0,0,   1,0,0,
+     0.1f,-0.1f, 0.1f,  1,1,1,1,  1,0,   1,0,0,
+     0.1f,-0.1f,-0.1f,  1,1,1,1,  1,1,   1,0,0,
+     0.1f, 0.1f,-0.1f,  1,1,1,1,  0,1,   1,0,0,
+
+    // Back
+     0.1f, 0.1f,-0.1f,  1,1,1,1,  0,0,  0,0,-1,
+     0.1f,-0.1f,-0.1f,  1,1,1,1,  1,0,  0,0,-1,
+    -0.1f,-0.1f,-0.1f,  1,1,1,1,  1,1,  0,0,-1,
+    -0.1f, 0.1f,-0.1f,  1,1,1,1,  0,1,  0,0,-1,
+};
+
+void BuildCube(std::vector<float>& out)
+{
+    out.assign(CUBE_VERTS, CUBE_VERTS + sizeof(CUBE_VERTS) / sizeof(float));
+}
@@ -0,0 +1,284 @@
+#include "Header/MeshCache.h"
+#include "Header/AssetArchive.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static constexpr char     MESHBIN_MAGIC[4] = { 'M', 'S', 'H', 'B' };
+static constexpr uint32_t MESHBIN_VERSION  = 7;
+
+struct MeshCacheHeader {
+    char     magic[4];
+    uint32_t version;
+    uint64_t srcSize;
+    int64_t  srcMtime;
+    uint64_t srcHash;
+    float    color[4];
+    uint64_t floatCount;
+    uint32_t rangeCount;
+    uint32_t indexCount;
+    float    boundsMin[3];
+    float    boundsMax[3];
+    uint32_t lodCount;
+    uint32_t reserved;
+    // Materijali (imena i teksture u rasponima) dolaze iz .mtl, pa je i on deo kljuca
+    uint64_t mtlSize;
+    uint64_t mtlHash;
+    char     mtlLib[64];
+};
+
+static_assert(sizeof(MeshCacheHeader) == 176, "meshbin header layout");
+static_assert(sizeof(MeshRange) == 128, "meshbin range layout");
+static_assert(sizeof(MeshLod) == 16, "meshbin lod layout");
+
+static bool HashFile(const char* path, uint64_t& out)
+{
+    MappedFile f;
+    if (!f.Open(path)) return false;
+    out = Fnv1a64(f.Data(), f.Size());
+    return true;
+}
+
+static std::string BaseDirOf(const char* path)
+{
+    std::string dir(path);
+    auto slash = dir.find_last_of("/\\");
+    return (slash == std::string::npos) ? "" : dir.substr(0, slash + 1);
+}
+
+// Sadrzaj prve mtllib linije (kao u parseru); false ako ne staje u zaglavlje
+static bool FindMtlLib(const unsigned char* data, size_t size, char (&out)[64])
+{
+    std::memset(out, 0, sizeof(out));
+    const char* p = (const char*)data;
+    const char* end = p + size;
+    while (p < end)
+    {
+        const char* lineEnd = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+        if (!lineEnd) lineEnd = end;
+        while (p < lineEnd && (*p == ' ' || *p == '\t')) p++;
+        if (lineEnd - p > 7 && std::memcmp(p, "mtllib", 6) == 0 && (p[6] == ' ' || p[6] == '\t'))
+        {
+            const char* b = p + 7;
+            const char* e = lineEnd;
+            while (b < e && (*b == ' ' || *b == '\t')) b++;
+            while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) e--;
+            if ((size_t)(e - b) >= sizeof(out)) return false;
+            std::memcpy(out, b, (size_t)(e - b));
+            return true;
+        }
+        p = lineEnd + 1;
+    }
+    return true;
+}
+
+// Velicina i hes prvog postojeceg .mtl iz linije (kao LoadMaterials); iz arhive se uzima contentHash
+static void StampMtlLib(const std::string& baseDir, const char* mtlLib, uint64_t& size, uint64_t& hash)
+{
+    size = 0;
+    hash = 0;
+    std::istringstream names(std::string(mtlLib, strnlen(mtlLib, 64)));
+    std::string name;
+    while (names >> name)
+    {
+        std::string path = baseDir + name;
+        if (const ArchiveEntry* e = gArchive.Find(path.c_str()))
+        {
+            size = e->size;
+            hash = e->contentHash;
+            return;
+        }
+        FileStamp st;
+        if (StatFile(path.c_str(), st) && HashFile(path.c_str(), hash))
+        {
+            size = st.size;
+            return;
+        }
+    }
+}
+
+static bool CheckMtlLib(const MeshCacheHeader& h, const char* srcPath)
+{
+    uint64_t size = 0, hash = 0;
+    StampMtlLib(BaseDirOf(srcPath), h.mtlLib, size, hash);
+    return size == h.mtlSize && hash == h.mtlHash;
+}
+
+static bool PatchHeader(const std::string& cachePath, const MeshCacheHeader& h)
+{
+    std::fstream patch(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+    if (!patch) return false;
+    patch.write((const char*)&h, sizeof(h));
+    patch.flush();
+    return (bool)patch;
+}
+
+static bool CheckHeader(const MeshCacheHeader& h, const glm::vec4& color, uint64_t srcSize)
+{
+    if (std::memcmp(h.magic, MESHBIN_MAGIC, 4) != 0) return false;
+    if (h.version != MESHBIN_VERSION) return false;
+    if (h.srcSize != srcSize) return false;
+    if (h.color[0] != color.r || h.color[1] != color.g || h.color[2] != color.b || h.color[3] != color.a) return false;
+    return true;
+}
+
+static size_t PayloadBytes(const MeshCacheHeader& h)
+{
+    return (size_t)h.rangeCount * sizeof(MeshRange) + (size_t)h.lodCount * sizeof(MeshLod)
+         + (size_t)h.indexCount * sizeof(uint32_t) + (size_t)h.floatCount * sizeof(float);
+}
+
+static void FillView(const unsigned char* data, const MeshCacheHeader& h, MeshCacheView& out)
+{
+    const unsigned char* base = data + sizeof(MeshCacheHeader);
+    size_t rangeBytes = (size_t)h.rangeCount * sizeof(MeshRange);
+    size_t lodBytes = (size_t)h.lodCount * sizeof(MeshLod);
+    size_t indexBytes = (size_t)h.indexCount * sizeof(uint32_t);
+
+    out.ranges = (const MeshRange*)base;
+    out.rangeCount = h.rangeCount;
+    out.lods = (const MeshLod*)(base + rangeBytes);
+    out.lodCount = h.lodCount;
+    out.indices = (const uint32_t*)(base + rangeBytes + lodBytes);
+    out.indexCount = h.indexCount;
+    out.vertices = (const float*)(base + rangeBytes + lodBytes + indexBytes);
+    out.floatCount = (size_t)h.floatCount;
+}
+
+// Kes spakovan u arhivu uz izvor; umesto mtime-a proverava se hes izvora iz tabele sadrzaja
+static const ArchiveEntry* FindArchivedCache(const char* srcPath, const glm::vec4& color, MeshCacheHeader& h)
+{
+    const ArchiveEntry* src = gArchive.Find(srcPath);
+    if (!src) return nullptr;
+
+    const ArchiveEntry* cache = gArchive.Find(MeshCachePath(srcPath).c_str());
+    if (!cache || cache->size < sizeof(MeshCacheHeader)) return nullptr;
+
+    std::memcpy(&h, gArchive.Data(*cache), sizeof(h));
+    if (!CheckHeader(h, color, src->size) || h.srcHash != src->contentHash) return nullptr;
+    if (cache->size != sizeof(MeshCacheHeader) + PayloadBytes(h)) return nullptr;
+    return cache;
+}
+
+std::string MeshCachePath(const char* srcPath)
+{
+    return std::string(srcPath) + ".meshbin";
+}
+
+bool OpenMeshCache(const char* srcPath, const glm::vec4& color, MeshCacheView& out)
+{
+    MeshCacheHeader h;
+    if (const ArchiveEntry* cache = FindArchivedCache(srcPath, color, h))
+    {
+        if (!CheckMtlLib(h, srcPath)) return false;
+        FillView(gArchive.Data(*cache), h, out);
+        return true;
+    }
+
+    FileStamp src;
+    if (!StatFile(srcPath, src)) return false;
+
+    std::string cachePath = MeshCachePath(srcPath);
+
+    MappedFile f;
+    if (!f.Open(cachePath.c_str())) return false;
+    if (f.Size() < sizeof(MeshCacheHeader)) return false;
+
+    std::memcpy(&h, f.Data(), sizeof(h));
+
+    if (!CheckHeader(h, color, src.size)) return false;
+    if (f.Size() != sizeof(MeshCacheHeader) + PayloadBytes(h)) return false;
+    if (!CheckMtlLib(h, srcPath)) return false;
+
+    // Kopiranje resursa (npr. CMake copy_directory) menja mtime, pa tada proveravamo sadrzaj
+    if (h.srcMtime != src.mtime) {
+        uint64_t hash = 0;
+        if (!HashFile(srcPath, hash) || hash != h.srcHash) return false;
+
+        // Na Windows-u se mapiran fajl ne moze otvoriti za pisanje, pa se mapiranje prvo zatvara
+        h.srcMtime = src.mtime;
+        f.Close();
+        if (!PatchHeader(cachePath, h))
+            std::cout << "[MESHBIN] " << cachePath << " | zaglavlje nije azurirano, izvor ce se opet hesirati\n";
+        if (!f.Open(cachePath.c_str()) || f.Size() != sizeof(MeshCacheHeader) + PayloadBytes(h)) return false;
+    }
+
+    FillView(f.Data(), h, out);
+    out.file = std::move(f);
+    return true;
+}
+
+bool PeekMeshCacheBounds(const char* srcPath, const glm::vec4& color, glm::vec3& outMin, glm::vec3& outMax)
+{
+    MeshCacheHeader h;
+    if (!FindArchivedCache(srcPath, color, h))
+    {
+        FileStamp src;
+        if (!StatFile(srcPath, src)) return false;
+
+        std::ifstream in(MeshCachePath(srcPath), std::ios::binary);
+        if (!in) return false;
+        if (!in.read((char*)&h, sizeof(h))) return false;
+        if (!CheckHeader(h, color, src.size)) return false;
+    }
+
+    outMin = glm::vec3(h.boundsMin[0], h.boundsMin[1], h.boundsMin[2]);
+    outMax = glm::vec3(h.boundsMax[0], h.boundsMax[1], h.boundsMax[2]);
+    return true;
+}
+
+bool SaveMeshCache(const char* srcPath, const glm::vec4& color, const MeshData& mesh)
+{
+    FileStamp src;
+    if (!StatFile(srcPath, src)) return false;
+
+    MeshCacheHeader h{};
+    std::memcpy(h.magic, MESHBIN_MAGIC, 4);
+    h.version = MESHBIN_VERSION;
+    h.srcSize = src.size;
+    h.srcMtime = src.mtime;
+    {
+        MappedFile obj;
+        if (!obj.Open(srcPath)) return false;
+        h.srcHash = Fnv1a64(obj.Data(), obj.Size());
+        if (!FindMtlLib(obj.Data(), obj.Size(), h.mtlLib)) return false;
+    }
+    StampMtlLib(BaseDirOf(srcPath), h.mtlLib, h.mtlSize, h.mtlHash);
+    h.color[0] = color.r; h.color[1] = color.g; h.color[2] = color.b; h.color[3] = color.a;
+    h.floatCount = mesh.vertices.size();
+    h.rangeCount = (uint32_t)mesh.ranges.size();
+    h.indexCount = (uint32_t)mesh.indices.size();
+    h.lodCount = (uint32_t)mesh.lods.size();
+
+    glm::vec3 bmin(0.0f), bmax(0.0f);
+    for (size_t i = 0; i < mesh.vertices.size(); i += MESH_STRIDE_FLOATS)
+    {
+        glm::vec3 p(mesh.vertices[i + 0], mesh.vertices[i + 1], mesh.vertices[i + 2]);
+        bmin = (i == 0) ? p : glm::min(bmin, p);
+        bmax = (i == 0) ? p : glm::max(bmax, p);
+    }
+    for (int k = 0; k < 3; k++) { h.boundsMin[k] = bmin[k]; h.boundsMax[k] = bmax[k]; }
+
+    std::string cachePath = MeshCachePath(srcPath);
+    // Vise niti moze istovremeno da pravi kes za isti fajl
+    size_t tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+    std::string tmpPath = cachePath + "." + std::to_string(tid) + ".tmp";
+
+    {
+        std::ofstream o(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!o) return false;
+        o.write((const char*)&h, sizeof(h));
+        o.write((const char*)mesh.ranges.data(), (std::streamsize)(mesh.ranges.size() * sizeof(MeshRange)));
+        o.write((const char*)mesh.lods.data(), (std::streamsize)(mesh.lods.size() * sizeof(MeshLod)));
+        o.write((const char*)mesh.indices.data(), (std::streamsize)(mesh.indices.size() * sizeof(uint32_t)));
+        o.write((const char*)mesh.vertices.data(), (std::streamsize)(mesh.vertices.size() * sizeof(float)));
+        if (!o) { o.close(); std::remove(tmpPath.c_str()); return false; }
+    }
+
+    std::remove(cachePath.c_str());
+    return std::rename(tmpPath.c_str(), cachePath.c_str()) == 0;
+}
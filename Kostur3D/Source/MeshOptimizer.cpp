@@ -0,0 +1,298 @@
+#include "Header/MeshOptimizer.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+float ComputeACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize)
+{
+    if (indexCount < 3) return 0.0f;
+
+    // Vreme ulaska u FIFO; verteks je u kesu ako je usao u poslednjih cacheSize promasaja
+    std::vector<size_t> stamp(vertexCount, 0);
+    size_t misses = 0;
+
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        uint32_t v = indices[i];
+        if (stamp[v] == 0 || misses - stamp[v] >= cacheSize)
+        {
+            misses++;
+            stamp[v] = misses;
+        }
+    }
+    return (float)misses / (float)(indexCount / 3);
+}
+
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount,
+                         std::vector<uint32_t>* clusters, unsigned cacheSize)
+{
+    size_t triCount = indexCount / 3;
+    if (clusters) clusters->clear();
+    if (triCount == 0) return;
+
+    // Susedstvo verteks -> trouglovi
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; i++)
+        live[indices[i]]++;
+
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        offsets[v + 1] = offsets[v] + live[v];
+
+    std::vector<uint32_t> adjacency(triCount * 3);
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triCount; t++)
+            for (int k = 0; k < 3; k++)
+                adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<char> emitted(triCount, 0);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> out;
+    out.reserve(triCount * 3);
+
+    uint32_t time = cacheSize + 1;
+    size_t cursor = 0;
+    int64_t fan = 0;
+
+    // Prvi verteks koji ima trouglove
+    while (fan < (int64_t)vertexCount && live[fan] == 0) fan++;
+    if (clusters) clusters->push_back(0);
+
+    while (fan >= 0 && fan < (int64_t)vertexCount)
+    {
+        candidates.clear();
+
+        for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; a++)
+        {
+            uint32_t t = adjacency[a];
+            if (emitted[t]) continue;
+
+            for (int k = 0; k < 3; k++)
+            {
+                uint32_t v = indices[t * 3 + k];
+                out.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > cacheSize)
+                {
+                    cacheTime[v] = time;
+                    time++;
+                }
+            }
+            emitted[t] = 1;
+        }
+
+        // Sledeci verteks za lepezu: onaj koji ce najverovatnije jos biti u kesu
+        int64_t best = -1;
+        int bestPriority = -1;
+        for (uint32_t v : candidates)
+        {
+            if (live[v] == 0) continue;
+            int priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize)
+                priority = (int)(time - cacheTime[v]);
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                best = v;
+            }
+        }
+
+        if (best < 0)
+        {
+            // Slepa ulica - tvrda granica klastera
+            while (!deadEnd.empty() && best < 0)
+            {
+                uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) best = v;
+            }
+            while (best < 0 && cursor < vertexCount)
+            {
+                if (live[cursor] > 0) best = (int64_t)cursor;
+                cursor++;
+            }
+            if (best >= 0 && clusters && out.size() / 3 < triCount)
+                clusters->push_back((uint32_t)(out.size() / 3));
+        }
+
+        fan = best;
+    }
+
+    std::memcpy(indices, out.data(), out.size() * sizeof(uint32_t));
+}
+
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const float* vertices, size_t vertexCount,
+                      const std::vector<uint32_t>& clusters)
+{
+    size_t triCount = indexCount / 3;
+    if (triCount == 0 || clusters.size() < 2) return;
+
+    auto pos = [&](uint32_t v) {
+        const float* p = vertices + (size_t)v * MESH_STRIDE_FLOATS;
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+
+    struct Cluster { uint32_t begin, end; glm::vec3 center; glm::vec3 normal; float area; float sortKey; };
+    std::vector<Cluster> list(clusters.size());
+
+    for (size_t c = 0; c < clusters.size(); c++)
+    {
+        Cluster& cl = list[c];
+        cl.begin = clusters[c];
+        cl.end = (c + 1 < clusters.size()) ? clusters[c + 1] : (uint32_t)triCount;
+        cl.center = glm::vec3(0.0f);
+        cl.normal = glm::vec3(0.0f);
+        cl.area = 0.0f;
+
+        for (uint32_t t = cl.begin; t < cl.end; t++)
+        {
+            glm::vec3 a = pos(indices[t * 3 + 0]);
+            glm::vec3 b = pos(indices[t * 3 + 1]);
+            glm::vec3 d = pos(indices[t * 3 + 2]);
+            glm::vec3 n = glm::cross(b - a, d - a);
+            float area = glm::length(n) * 0.5f;
+
+            cl.center += (a + b + d) * (area / 3.0f);
+            cl.normal += n;
+            cl.area += area;
+        }
+
+        meshCenter += cl.center;
+        meshArea += cl.area;
+        if (cl.area > 0.0f) cl.center /= cl.area;
+    }
+
+    if (meshArea <= 0.0f) return;
+    meshCenter /= meshArea;
+
+    // Klasteri okrenuti ka spolja prvi - oni najcesce zaklanjaju ostatak modela
+    for (Cluster& cl : list)
+    {
+        float len = glm::length(cl.normal);
+        glm::vec3 n = len > 0.0f ? cl.normal / len : glm::vec3(0.0f);
+        cl.sortKey = glm::dot(cl.center - meshCenter, n);
+    }
+
+    std::stable_sort(list.begin(), list.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> out;
+    out.reserve(triCount * 3);
+    for (const Cluster& cl : list)
+        out.insert(out.end(), indices + cl.begin * 3, indices + cl.end * 3);
+
+    std::memcpy(indices, out.data(), out.size() * sizeof(uint32_t));
+}
+
+void OptimizeVertexFetch(std::vector<float>& vertices, std::vector<uint32_t>& indices)
+{
+    size_t vertexCount = vertices.size() / MESH_STRIDE_FLOATS;
+    const uint32_t unused = 0xFFFFFFFFu;
+
+    std::vector<uint32_t> remap(vertexCount, unused);
+    std::vector<float> out;
+    out.reserve(vertices.size());
+
+    for (uint32_t& idx : indices)
+    {
+        if (remap[idx] == unused)
+        {
+            remap[idx] = (uint32_t)(out.size() / MESH_STRIDE_FLOATS);
+            const float* p = vertices.data() + (size_t)idx * MESH_STRIDE_FLOATS;
+            out.insert(out.end(), p, p + MESH_STRIDE_FLOATS);
+        }
+        idx = remap[idx];
+    }
+
+    vertices.swap(out);
+}
+
+void OptimizeMesh(MeshData& mesh, const char* name)
+{
+    size_t vertexCount = mesh.VertexCount();
+    if (mesh.indices.empty() || vertexCount == 0) return;
+
+    float before = ComputeACMR(mesh.indices.data(), mesh.indices.size(), vertexCount);
+
+    std::vector<MeshRange> ranges = mesh.ranges;
+    if (ranges.empty())
+    {
+        MeshRange all;
+        all.count = (uint32_t)mesh.indices.size();
+        ranges.push_back(all);
+    }
+
+    std::vector<uint32_t> clusters;
+    for (const MeshRange& r : ranges)
+    {
+        uint32_t* idx = mesh.indices.data() + r.first;
+        OptimizeVertexCache(idx, r.count, vertexCount, &clusters);
+        OptimizeOverdraw(idx, r.count, mesh.vertices.data(), vertexCount, clusters);
+    }
+
+    OptimizeVertexFetch(mesh.vertices, mesh.indices);
+
+    float after = ComputeACMR(mesh.indices.data(), mesh.indices.size(), mesh.VertexCount());
+    if (name)
+        std::cout << "[MESH OPT] " << name << " | ACMR " << before << " -> " << after << "\n";
+}
+
+struct VertexKey {
+    const float* p;
+    bool operator==(const VertexKey& o) const { return std::memcmp(p, o.p, MESH_STRIDE_FLOATS * sizeof(float)) == 0; }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& k) const
+    {
+        const unsigned char* b = (const unsigned char*)k.p;
+        size_t h = 1469598103934665603ull;
+        for (size_t i = 0; i < MESH_STRIDE_FLOATS * sizeof(float); i++)
+        {
+            h ^= b[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+};
+
+void MeshDataFromFloats(const std::vector<float>& data, MeshData& out)
+{
+    size_t n = data.size() / MESH_STRIDE_FLOATS;
+
+    out.vertices.clear();
+    out.indices.clear();
+    out.ranges.clear();
+    out.indices.reserve(n);
+
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> seen;
+    seen.reserve(n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const float* p = data.data() + i * MESH_STRIDE_FLOATS;
+        auto it = seen.find(VertexKey{ p });
+        if (it == seen.end())
+        {
+            uint32_t id = (uint32_t)(out.vertices.size() / MESH_STRIDE_FLOATS);
+            out.vertices.insert(out.vertices.end(), p, p + MESH_STRIDE_FLOATS);
+            it = seen.emplace(VertexKey{ p }, id).first;
+        }
+        out.indices.push_back(it->second);
+    }
+
+    MeshRange all;
+    all.count = (uint32_t)out.indices.size();
+    out.ranges.push_back(all);
+}
@@ -0,0 +1,341 @@
+#include "Header/MeshSimplifier.h"
+#include "Header/MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+// Simetricna 4x4 matrica ravni + ukupna tezina (povrsina), da bi greska bila kvadrat udaljenosti
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+    double w = 0;
+
+    void AddPlane(double nx, double ny, double nz, double d, double weight)
+    {
+        a00 += weight * nx * nx; a01 += weight * nx * ny; a02 += weight * nx * nz; a03 += weight * nx * d;
+        a11 += weight * ny * ny; a12 += weight * ny * nz; a13 += weight * ny * d;
+        a22 += weight * nz * nz; a23 += weight * nz * d;
+        a33 += weight * d * d;
+        w += weight;
+    }
+
+    void Add(const Quadric& o)
+    {
+        a00 += o.a00; a01 += o.a01; a02 += o.a02; a03 += o.a03;
+        a11 += o.a11; a12 += o.a12; a13 += o.a13;
+        a22 += o.a22; a23 += o.a23;
+        a33 += o.a33;
+        w += o.w;
+    }
+
+    double Error(const glm::vec3& p) const
+    {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x
+                 + a11 * y * y + 2 * a12 * y * z + 2 * a13 * y
+                 + a22 * z * z + 2 * a23 * z
+                 + a33;
+        return w > 0 ? std::fabs(e) / w : 0.0;
+    }
+};
+
+enum class VertexKind : uint8_t { Manifold, Border, Locked };
+
+struct PositionKey {
+    float x, y, z;
+    bool operator==(const PositionKey& o) const { return x == o.x && y == o.y && z == o.z; }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& k) const
+    {
+        uint32_t b[3];
+        std::memcpy(b, &k, sizeof(b));
+        return (size_t)b[0] * 73856093u ^ (size_t)b[1] * 19349663u ^ (size_t)b[2] * 83492791u;
+    }
+};
+
+static uint64_t EdgeKey(uint32_t a, uint32_t b)
+{
+    if (a > b) std::swap(a, b);
+    return ((uint64_t)a << 32) | b;
+}
+
+struct Collapse {
+    uint32_t from, to;
+    double cost;
+};
+
+size_t SimplifyMesh(std::vector<uint32_t>& out, const uint32_t* indices, size_t indexCount,
+                    const float* vertices, size_t vertexCount, size_t targetIndexCount, float* outError)
+{
+    out.assign(indices, indices + indexCount);
+    if (outError) *outError = 0.0f;
+    if (indexCount <= targetIndexCount || vertexCount == 0) return out.size();
+
+    auto pos = [&](uint32_t v) {
+        const float* p = vertices + (size_t)v * MESH_STRIDE_FLOATS;
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    // Verteksi na istoj poziciji (savovi) dele kvadriku i ivice
+    std::vector<uint32_t> posId(vertexCount);
+    std::vector<uint32_t> posUsers(vertexCount, 0);
+    {
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> seen;
+        seen.reserve(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            glm::vec3 p = pos(v);
+            auto it = seen.emplace(PositionKey{ p.x, p.y, p.z }, v).first;
+            posId[v] = it->second;
+        }
+        std::vector<char> used(vertexCount, 0);
+        for (size_t i = 0; i < indexCount; i++)
+            used[indices[i]] = 1;
+        for (uint32_t v = 0; v < vertexCount; v++)
+            if (used[v]) posUsers[posId[v]]++;
+    }
+
+    // Ivice koje koristi samo jedan trougao su rub otvorene mreze
+    std::unordered_map<uint64_t, uint32_t> edgeUse;
+    edgeUse.reserve(indexCount);
+    for (size_t t = 0; t < indexCount; t += 3)
+        for (int k = 0; k < 3; k++)
+            edgeUse[EdgeKey(posId[indices[t + k]], posId[indices[t + (k + 1) % 3]])]++;
+
+    std::vector<VertexKind> kind(vertexCount, VertexKind::Manifold);
+    std::vector<Quadric> quadrics(vertexCount);
+
+    for (size_t t = 0; t < indexCount; t += 3)
+    {
+        glm::vec3 p0 = pos(indices[t + 0]), p1 = pos(indices[t + 1]), p2 = pos(indices[t + 2]);
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        float len = glm::length(n);
+        if (len <= 0.0f) continue;
+        n /= len;
+
+        double area = len * 0.5;
+        double d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; k++)
+            quadrics[posId[indices[t + k]]].AddPlane(n.x, n.y, n.z, d, area);
+
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t a = posId[indices[t + k]], b = posId[indices[t + (k + 1) % 3]];
+            if (edgeUse[EdgeKey(a, b)] != 1) continue;
+
+            kind[a] = kind[b] = VertexKind::Border;
+
+            // Ravan kroz ivicu, normalna na trougao - drzi obris na mestu
+            glm::vec3 e = pos(b) - pos(a);
+            glm::vec3 bn = glm::cross(e, n);
+            float bl = glm::length(bn);
+            if (bl <= 0.0f) continue;
+            bn /= bl;
+            double bd = -glm::dot(bn, pos(a));
+            double weight = glm::dot(e, e) * 10.0;
+            quadrics[a].AddPlane(bn.x, bn.y, bn.z, bd, weight);
+            quadrics[b].AddPlane(bn.x, bn.y, bn.z, bd, weight);
+        }
+    }
+
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        if (posUsers[posId[v]] > 1) kind[posId[v]] = VertexKind::Locked;
+        kind[v] = kind[posId[v]];
+    }
+
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<char> touched(vertexCount);
+    std::vector<uint32_t> adjOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint64_t> edges;
+    std::vector<Collapse> collapses;
+    double maxError = 0.0;
+
+    while (out.size() > targetIndexCount)
+    {
+        size_t triCount = out.size() / 3;
+
+        // Trouglovi oko svakog verteksa, za proveru prevrtanja
+        std::fill(adjOffsets.begin(), adjOffsets.end(), 0);
+        for (uint32_t v : out) adjOffsets[v + 1]++;
+        for (size_t v = 0; v < vertexCount; v++) adjOffsets[v + 1] += adjOffsets[v];
+        adjacency.resize(out.size());
+        {
+            std::vector<uint32_t> fill(adjOffsets.begin(), adjOffsets.end() - 1);
+            for (size_t i = 0; i < out.size(); i++)
+                adjacency[fill[out[i]]++] = (uint32_t)(i / 3);
+        }
+
+        edges.clear();
+        for (size_t t = 0; t < out.size(); t += 3)
+            for (int k = 0; k < 3; k++)
+                edges.push_back(EdgeKey(out[t + k], out[t + (k + 1) % 3]));
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        auto canCollapse = [&](uint32_t from, uint32_t to) {
+            if (kind[from] == VertexKind::Manifold) return true;
+            if (kind[from] == VertexKind::Border)
+                return kind[to] != VertexKind::Manifold && edgeUse[EdgeKey(posId[from], posId[to])] == 1;
+            return false;
+        };
+
+        collapses.clear();
+        for (uint64_t e : edges)
+        {
+            uint32_t a = (uint32_t)(e >> 32), b = (uint32_t)e;
+            if (posId[a] == posId[b]) continue;
+
+            Quadric q = quadrics[posId[a]];
+            q.Add(quadrics[posId[b]]);
+
+            if (canCollapse(a, b)) collapses.push_back({ a, b, q.Error(pos(b)) });
+            if (canCollapse(b, a)) collapses.push_back({ b, a, q.Error(pos(a)) });
+        }
+        if (collapses.empty()) break;
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        for (uint32_t v = 0; v < vertexCount; v++) remap[v] = v;
+        std::fill(touched.begin(), touched.end(), 0);
+
+        size_t removeGoal = triCount - targetIndexCount / 3;
+        size_t removed = 0;
+        size_t applied = 0;
+
+        for (const Collapse& c : collapses)
+        {
+            if (removed >= removeGoal) break;
+            if (touched[c.from] || touched[c.to]) continue;
+
+            glm::vec3 target = pos(c.to);
+            bool flips = false;
+            size_t dying = 0;
+
+            for (uint32_t a = adjOffsets[c.from]; a < adjOffsets[c.from + 1] && !flips; a++)
+            {
+                const uint32_t* tri = &out[adjacency[a] * 3];
+                if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) { dying++; continue; }
+
+                glm::vec3 p[3], q[3];
+                for (int k = 0; k < 3; k++)
+                {
+                    p[k] = pos(tri[k]);
+                    q[k] = (tri[k] == c.from) ? target : p[k];
+                }
+                glm::vec3 n0 = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 n1 = glm::cross(q[1] - q[0], q[2] - q[0]);
+                if (glm::dot(n0, n1) <= 0.0f) flips = true;
+            }
+            if (flips || dying == 0) continue;
+
+            // Zakljucaj 1-prsten da bi provere ostalih skupljanja u ovom prolazu ostale tacne
+            for (uint32_t a = adjOffsets[c.from]; a < adjOffsets[c.from + 1]; a++)
+            {
+                const uint32_t* tri = &out[adjacency[a] * 3];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+            }
+
+            remap[c.from] = c.to;
+            quadrics[posId[c.to]].Add(quadrics[posId[c.from]]);
+            maxError = std::max(maxError, c.cost);
+            removed += dying;
+            applied++;
+        }
+
+        if (applied == 0) break;
+
+        size_t write = 0;
+        for (size_t t = 0; t < out.size(); t += 3)
+        {
+            uint32_t a = remap[out[t]], b = remap[out[t + 1]], c = remap[out[t + 2]];
+            if (a == b || b == c || a == c) continue;
+            out[write++] = a;
+            out[write++] = b;
+            out[write++] = c;
+        }
+        out.resize(write);
+    }
+
+    if (outError) *outError = (float)std::sqrt(maxError);
+    return out.size();
+}
+
+void BuildMeshLods(MeshData& mesh, const char* name)
+{
+    mesh.lods.clear();
+    if (mesh.indices.empty()) return;
+
+    size_t vertexCount = mesh.VertexCount();
+    size_t baseCount = mesh.indices.size();
+
+    std::vector<MeshRange> ranges = mesh.ranges;
+    if (ranges.empty())
+    {
+        MeshRange all;
+        all.count = (uint32_t)baseCount;
+        ranges.push_back(all);
+    }
+
+    MeshLod base;
+    base.count = (uint32_t)baseCount;
+    mesh.lods.push_back(base);
+
+    // Svaki nivo krece od prethodnog, greske se sabiraju
+    std::vector<std::vector<uint32_t>> current(ranges.size());
+    for (size_t r = 0; r < ranges.size(); r++)
+        current[r].assign(mesh.indices.begin() + ranges[r].first, mesh.indices.begin() + ranges[r].first + ranges[r].count);
+
+    static const float ratios[MESH_MAX_LODS - 1] = { 0.5f, 0.25f, 0.125f };
+    size_t prevCount = baseCount;
+    float prevError = 0.0f;
+
+    std::vector<uint32_t> next;
+    for (float ratio : ratios)
+    {
+        std::vector<uint32_t> level;
+        float levelError = 0.0f;
+
+        for (size_t r = 0; r < ranges.size(); r++)
+        {
+            size_t target = (size_t)(ranges[r].count * ratio) / 3 * 3;
+            float err = 0.0f;
+            SimplifyMesh(next, current[r].data(), current[r].size(), mesh.vertices.data(), vertexCount, target, &err);
+            OptimizeVertexCache(next.data(), next.size(), vertexCount);
+
+            levelError = std::max(levelError, err);
+            current[r].swap(next);
+            level.insert(level.end(), current[r].begin(), current[r].end());
+        }
+
+        // Nivo koji skoro nista ne stedi samo trosi memoriju
+        if (level.empty() || level.size() > prevCount * 9 / 10)
+            break;
+
+        MeshLod lod;
+        lod.first = (uint32_t)mesh.indices.size();
+        lod.count = (uint32_t)level.size();
+        lod.error = prevError + levelError;
+        mesh.lods.push_back(lod);
+        mesh.indices.insert(mesh.indices.end(), level.begin(), level.end());
+
+        prevCount = level.size();
+        prevError = lod.error;
+    }
+
+    if (name)
+    {
+        std::cout << "[MESH LOD] " << name << " | tris";
+        for (const MeshLod& l : mesh.lods)
+            std::cout << " " << l.count / 3 << " (" << l.error << ")";
+        std::cout << "\n";
+    }
+}
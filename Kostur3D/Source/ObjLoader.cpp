@@ -0,0 +1,311 @@
+#include "Header/ObjLoader.h"
+#include "Header/AssetArchive.h"
+#include "Header/MeshCache.h"
+#include "Header/MeshOptimizer.h"
+#include "Header/MeshSimplifier.h"
+#include "Header/ObjParser.h"
+#include "Header/tiny_obj_loader.h"
+#include "Util.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+struct ObjCorner {
+    int v, n, t;
+    bool operator==(const ObjCorner& o) const { return v == o.v && n == o.n && t == o.t; }
+};
+
+struct ObjCornerHash {
+    size_t operator()(const ObjCorner& c) const
+    {
+        size_t h = (size_t)(uint32_t)c.v * 73856093u;
+        h ^= (size_t)(uint32_t)c.n * 19349663u;
+        h ^= (size_t)(uint32_t)c.t * 83492791u;
+        return h;
+    }
+};
+
+static std::string BaseDirOf(const char* path)
+{
+    std::string baseDir = std::string(path);
+    auto slash = baseDir.find_last_of("/\\");
+    return (slash == std::string::npos) ? "" : baseDir.substr(0, slash + 1);
+}
+
+// .mtl preko ReadAsset, da bi tinyobj radio i sa fajlovima iz arhive
+class AssetMaterialReader : public tinyobj::MaterialReader {
+public:
+    explicit AssetMaterialReader(const std::string& baseDir) : baseDir(baseDir) {}
+
+    bool operator()(const std::string& matId, std::vector<tinyobj::material_t>* materials,
+                    std::map<std::string, int>* matMap, std::string* warn, std::string* err) override
+    {
+        std::string text;
+        if (!ReadAsset((baseDir + matId).c_str(), text))
+        {
+            if (warn) *warn += "Material file [ " + matId + " ] not found.\n";
+            return false;
+        }
+        std::istringstream in(text);
+        tinyobj::LoadMtl(matMap, materials, &in, warn, err);
+        return true;
+    }
+
+private:
+    std::string baseDir;
+};
+
+static bool ParseObjWithTinyObj(const char* objPath, const glm::vec4& color, MeshData& out)
+{
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+
+    std::string baseDir = BaseDirOf(objPath);
+
+    std::string text;
+    if (!ReadAsset(objPath, text))
+        return false;
+
+    std::istringstream in(text);
+    AssetMaterialReader mtlReader(baseDir);
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &in, &mtlReader, true))
+        return false;
+
+    out.vertices.clear();
+    out.indices.clear();
+    out.ranges.clear();
+    out.lods.clear();
+
+    // Isti (v, vn, vt) trojac se deli izmedju lica - jedan verteks, vise indeksa
+    std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> corners;
+    corners.reserve(attrib.vertices.size() / 3 * 2);
+
+    // Kanta 0 su lica bez materijala, kanta i+1 je materijal i
+    std::vector<std::vector<uint32_t>> buckets(materials.size() + 1);
+
+    auto pushV = [&](float px,float py,float pz, float u,float v, float nx,float ny,float nz)
+    {
+        std::vector<float>& data = out.vertices;
+        data.push_back(px); data.push_back(py); data.push_back(pz);
+        data.push_back(color.r); data.push_back(color.g); data.push_back(color.b); data.push_back(color.a);
+        data.push_back(u); data.push_back(v);
+        data.push_back(nx); data.push_back(ny); data.push_back(nz);
+    };
+
+    auto vertexFor = [&](const tinyobj::index_t& idx) -> uint32_t
+    {
+        ObjCorner key{ idx.vertex_index, idx.normal_index, idx.texcoord_index };
+        auto it = corners.find(key);
+        if (it != corners.end()) return it->second;
+
+        float px = attrib.vertices[3 * idx.vertex_index + 0];
+        float py = attrib.vertices[3 * idx.vertex_index + 1];
+        float pz = attrib.vertices[3 * idx.vertex_index + 2];
+
+        float nx=0, ny=1, nz=0;
+        if (idx.normal_index >= 0){
+            nx = attrib.normals[3 * idx.normal_index + 0];
+            ny = attrib.normals[3 * idx.normal_index + 1];
+            nz = attrib.normals[3 * idx.normal_index + 2];
+        }
+
+        float u=0, v=0;
+        if (idx.texcoord_index >= 0){
+            u = attrib.texcoords[2 * idx.texcoord_index + 0];
+            v = attrib.texcoords[2 * idx.texcoord_index + 1];
+        }
+
+        uint32_t id = (uint32_t)out.VertexCount();
+        pushV(px,py,pz, u,v, nx,ny,nz);
+        corners.emplace(key, id);
+        return id;
+    };
+
+    for (const auto& s : shapes)
+    {
+        size_t index_offset = 0;
+        for (size_t f = 0; f < s.mesh.num_face_vertices.size(); f++)
+        {
+            int fv = s.mesh.num_face_vertices[f];
+            int faceMat = (f < s.mesh.material_ids.size()) ? s.mesh.material_ids[f] : -1;
+            if (faceMat < -1 || faceMat >= (int)materials.size()) faceMat = -1;
+
+            std::vector<uint32_t>& target = buckets[faceMat + 1];
+
+            for (int vtx = 0; vtx < fv; vtx++)
+                target.push_back(vertexFor(s.mesh.indices[index_offset + vtx]));
+
+            index_offset += fv;
+        }
+    }
+
+    size_t total = 0;
+    for (const auto& b : buckets) total += b.size();
+    out.indices.reserve(total);
+
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        if (buckets[i].empty()) continue;
+
+        MeshRange r;
+        r.first = (uint32_t)out.indices.size();
+        r.count = (uint32_t)buckets[i].size();
+        r.materialId = (int32_t)i - 1;
+        if (r.materialId >= 0)
+        {
+            std::strncpy(r.name, materials[r.materialId].name.c_str(), sizeof(r.name) - 1);
+            std::strncpy(r.diffuseTex, materials[r.materialId].diffuse_texname.c_str(), sizeof(r.diffuseTex) - 1);
+        }
+
+        out.ranges.push_back(r);
+        out.indices.insert(out.indices.end(), buckets[i].begin(), buckets[i].end());
+    }
+    return true;
+}
+
+bool ParseObjToMeshData(const char* objPath, const glm::vec4& color, MeshData& out)
+{
+    if (FastParseObjToMeshData(objPath, color, out))
+        return true;
+
+    std::cout << "[OBJ] " << objPath << " | brzi parser ne podrzava fajl, koristi se tinyobj\n";
+    return ParseObjWithTinyObj(objPath, color, out);
+}
+
+bool LoadObjPayload(const char* objPath, const glm::vec4& color, ObjPayload& out)
+{
+    out.baseDir = BaseDirOf(objPath);
+
+    MeshCacheView& view = out.view;
+    if (OpenMeshCache(objPath, color, view))
+        return true;
+
+    MeshData& parsed = out.parsed;
+    if (!ParseObjToMeshData(objPath, color, parsed))
+        return false;
+
+    // Kes cuva vec optimizovan redosled, pa se ovo placa samo pri prvom ucitavanju
+    OptimizeMesh(parsed, objPath);
+    BuildMeshLods(parsed, objPath);
+    SaveMeshCache(objPath, color, parsed);
+
+    view.vertices = parsed.vertices.data();
+    view.floatCount = parsed.vertices.size();
+    view.indices = parsed.indices.data();
+    view.indexCount = parsed.indices.size();
+    view.ranges = parsed.ranges.data();
+    view.rangeCount = parsed.ranges.size();
+    view.lods = parsed.lods.data();
+    view.lodCount = parsed.lods.size();
+    return true;
+}
+
+std::vector<std::string> ObjDiffuseTextures(const ObjPayload& p, const std::vector<std::string>& onlyMaterials)
+{
+    std::vector<std::string> out;
+    for (size_t i = 0; i < p.view.rangeCount; i++)
+    {
+        const MeshRange& r = p.view.ranges[i];
+        if (r.diffuseTex[0] == 0) continue;
+        if (!onlyMaterials.empty() && std::find(onlyMaterials.begin(), onlyMaterials.end(), r.name) == onlyMaterials.end()) continue;
+
+        std::string path = p.baseDir + r.diffuseTex;
+        if (std::find(out.begin(), out.end(), path) == out.end())
+            out.push_back(path);
+    }
+    return out;
+}
+
+// Nivoi detalja su na kraju indeksnog bafera; pun model je samo prvi raspon
+static void CopyLods(const MeshCacheView& view, MeshGL& outMesh)
+{
+    outMesh.lods.clear();
+    for (size_t i = 0; i < view.lodCount; i++)
+    {
+        LodLevel l;
+        l.first = (GLsizei)view.lods[i].first;
+        l.count = (GLsizei)view.lods[i].count;
+        l.error = view.lods[i].error;
+        outMesh.lods.push_back(l);
+    }
+    if (!outMesh.lods.empty())
+        outMesh.indexCount = outMesh.lods[0].count;
+}
+
+void UploadObjMesh(const ObjPayload& p, Renderer& R, MeshGL& outMesh, VertexFormat format)
+{
+    const MeshCacheView& view = p.view;
+    R.CreateMesh(outMesh, format, view.vertices, view.floatCount, view.indices, view.indexCount);
+    CopyLods(view, outMesh);
+}
+
+bool UploadObjSubMeshes(const ObjPayload& p, Renderer& R, MeshGL& outMesh,
+                        const std::vector<std::string>& onlyMaterials,
+                        const std::function<TextureHandle(const std::string&)>& textureFor,
+                        VertexFormat format)
+{
+    const MeshCacheView& view = p.view;
+
+    auto makePart = [&](const MeshRange& r)
+    {
+        SubMesh part;
+        part.first = (GLsizei)r.first;
+        part.count = (GLsizei)r.count;
+        part.materialId = r.materialId;
+        if (r.diffuseTex[0]) part.tex = textureFor(p.baseDir + r.diffuseTex);
+        part.name = r.name;
+        return part;
+    };
+
+    std::vector<SubMesh> parts;
+    if (onlyMaterials.empty())
+    {
+        for (size_t i = 0; i < view.rangeCount; i++)
+            parts.push_back(makePart(view.ranges[i]));
+    }
+    else
+    {
+        for (const std::string& name : onlyMaterials)
+            for (size_t i = 0; i < view.rangeCount; i++)
+                if (view.ranges[i].materialId >= 0 && name == view.ranges[i].name)
+                    parts.push_back(makePart(view.ranges[i]));
+    }
+
+    if (parts.empty())
+        return false;
+
+    R.CreateMesh(outMesh, format, view.vertices, view.floatCount, view.indices, view.indexCount);
+    CopyLods(view, outMesh);
+    outMesh.parts = std::move(parts);
+    return true;
+}
+
+bool LoadObjToMeshGL(const char* objPath, Renderer& R, MeshGL& outMesh, const glm::vec4& color,
+                     VertexFormat format)
+{
+    ObjPayload p;
+    if (!LoadObjPayload(objPath, color, p))
+        return false;
+
+    UploadObjMesh(p, R, outMesh, format);
+    return true;
+}
+
+bool LoadObjToSubMeshes(const char* objPath, Renderer& R, MeshGL& outMesh, const glm::vec4& color,
+                        const std::vector<std::string>& onlyMaterials,
+                        VertexFormat format)
+{
+    ObjPayload p;
+    if (!LoadObjPayload(objPath, color, p))
+        return false;
+
+    // Svaki deo drzi svoju referencu; registar deli istu teksturu
+    auto textureFor = [](const std::string& path) { return gTextures.Load(path); };
+
+    return UploadObjSubMeshes(p, R, outMesh, onlyMaterials, textureFor, format);
+}
@@ -0,0 +1,514 @@
+#include "Header/ObjParser.h"
+#include "Header/AssetArchive.h"
+#include "Header/MappedFile.h"
+#include "Header/tiny_obj_loader.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Indeks koji se ne zna dok se ne spoje delovi: negativni OBJ indeksi su relativni
+// u odnosu na broj atributa do te linije, a delovi ne znaju koliko ih je bilo pre njih.
+struct ObjFaceCorner {
+    int32_t v = -1, t = -1, n = -1;
+    uint8_t rel = 0; // bit 0: v, bit 1: t, bit 2: n - vrednost je relativna u odnosu na pocetak dela
+};
+
+struct ObjMaterialRun {
+    uint32_t face;
+    int32_t name;
+};
+
+struct ObjChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    bool ok = true;
+
+    std::vector<float> positions, texcoords, normals;
+    std::vector<ObjFaceCorner> corners;
+    std::vector<uint8_t> faceSizes;
+    std::vector<ObjMaterialRun> runs;
+    std::vector<std::string> materialNames;
+    std::string mtllib;
+
+    // Posle spajanja
+    size_t vBase = 0, tBase = 0, nBase = 0;
+    int32_t startMaterial = -1;
+    std::vector<int32_t> materialIds;
+
+    std::vector<float> vertices;
+    std::vector<std::vector<uint32_t>> buckets;
+};
+
+template <typename Fn>
+static void RunParallel(size_t count, Fn fn)
+{
+    if (count == 1) { fn(0); return; }
+
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        threads.emplace_back(fn, i);
+    for (auto& t : threads)
+        t.join();
+}
+
+static inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static inline void SkipSpaces(const char*& p, const char* end)
+{
+    while (p < end && IsSpace(*p)) p++;
+}
+
+static const double kPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Bez lokalizacije i alokacija, kao std::from_chars (koji za float nije svuda dostupan)
+static bool ParseFloat(const char*& p, const char* end, float& out)
+{
+    SkipSpaces(p, end);
+
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); p++; }
+
+    uint64_t mant = 0;
+    int exp = 0;
+    int digits = 0;
+
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        if (mant < 100000000000000000ull) mant = mant * 10 + (uint64_t)(*p - '0');
+        else exp++;
+        digits++;
+        p++;
+    }
+    if (p < end && *p == '.')
+    {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            if (mant < 100000000000000000ull) { mant = mant * 10 + (uint64_t)(*p - '0'); exp--; }
+            digits++;
+            p++;
+        }
+    }
+    if (digits == 0) return false;
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool eneg = false;
+        if (p < end && (*p == '-' || *p == '+')) { eneg = (*p == '-'); p++; }
+        int e = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            if (e < 10000) e = e * 10 + (*p - '0');
+            p++;
+        }
+        exp += eneg ? -e : e;
+    }
+
+    double v = (double)mant;
+    while (exp > 22) { v *= 1e22; exp -= 22; }
+    while (exp < -22) { v /= 1e22; exp += 22; }
+    v = (exp >= 0) ? v * kPow10[exp] : v / kPow10[-exp];
+
+    out = (float)(neg ? -v : v);
+    return true;
+}
+
+static bool ParseInt(const char*& p, const char* end, int32_t& out)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); p++; }
+
+    int64_t v = 0;
+    int digits = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        v = v * 10 + (*p - '0');
+        if (v > INT32_MAX) return false;
+        digits++;
+        p++;
+    }
+    if (digits == 0) return false;
+
+    out = (int32_t)(neg ? -v : v);
+    return true;
+}
+
+// OBJ indeks (1-based ili negativan) u apsolutni 0-based ili relativan u odnosu na pocetak dela
+static bool ResolveLocal(int32_t idx, size_t localCount, int32_t& value, uint8_t& rel, uint8_t bit)
+{
+    if (idx > 0) { value = idx - 1; return true; }
+    if (idx < 0) { value = (int32_t)localCount + idx; rel |= bit; return true; }
+    return false;
+}
+
+static bool ParseCorner(const char*& p, const char* end, const ObjChunk& c, ObjFaceCorner& out)
+{
+    int32_t idx;
+    if (!ParseInt(p, end, idx)) return false;
+    if (!ResolveLocal(idx, c.positions.size() / 3, out.v, out.rel, 1)) return false;
+
+    if (p < end && *p == '/')
+    {
+        p++;
+        if (p < end && *p != '/')
+        {
+            if (!ParseInt(p, end, idx)) return false;
+            if (!ResolveLocal(idx, c.texcoords.size() / 2, out.t, out.rel, 2)) return false;
+        }
+        if (p < end && *p == '/')
+        {
+            p++;
+            if (!ParseInt(p, end, idx)) return false;
+            if (!ResolveLocal(idx, c.normals.size() / 3, out.n, out.rel, 4)) return false;
+        }
+    }
+    return p >= end || IsSpace(*p);
+}
+
+static std::string RestOfLine(const char* p, const char* end)
+{
+    SkipSpaces(p, end);
+    while (end > p && IsSpace(end[-1])) end--;
+    return std::string(p, end);
+}
+
+static bool ParseLine(ObjChunk& c, const char* p, const char* end)
+{
+    SkipSpaces(p, end);
+    if (p >= end || *p == '#') return true;
+
+    const char* kw = p;
+    while (p < end && !IsSpace(*p)) p++;
+    size_t kwLen = (size_t)(p - kw);
+
+    auto is = [&](const char* s) { return std::strlen(s) == kwLen && std::memcmp(kw, s, kwLen) == 0; };
+
+    if (is("v"))
+    {
+        float x, y, z;
+        if (!ParseFloat(p, end, x) || !ParseFloat(p, end, y) || !ParseFloat(p, end, z)) return false;
+        c.positions.push_back(x); c.positions.push_back(y); c.positions.push_back(z);
+        return true;
+    }
+    if (is("vt"))
+    {
+        float u, v = 0.0f;
+        if (!ParseFloat(p, end, u)) return false;
+        const char* q = p;
+        if (!ParseFloat(q, end, v)) v = 0.0f;
+        c.texcoords.push_back(u); c.texcoords.push_back(v);
+        return true;
+    }
+    if (is("vn"))
+    {
+        float x, y, z;
+        if (!ParseFloat(p, end, x) || !ParseFloat(p, end, y) || !ParseFloat(p, end, z)) return false;
+        c.normals.push_back(x); c.normals.push_back(y); c.normals.push_back(z);
+        return true;
+    }
+    if (is("f"))
+    {
+        ObjFaceCorner face[4];
+        int n = 0;
+        while (true)
+        {
+            SkipSpaces(p, end);
+            if (p >= end) break;
+            if (n == 4) return false; // poligone ostavljamo tinyobj triangulaciji
+            if (!ParseCorner(p, end, c, face[n])) return false;
+            n++;
+        }
+        if (n < 3) return true; // degenerisano lice, tinyobj ga isto preskace
+
+        c.corners.insert(c.corners.end(), face, face + n);
+        c.faceSizes.push_back((uint8_t)n);
+        return true;
+    }
+    if (is("usemtl"))
+    {
+        std::string name = RestOfLine(p, end);
+        auto it = std::find(c.materialNames.begin(), c.materialNames.end(), name);
+        int32_t id = (int32_t)(it - c.materialNames.begin());
+        if (it == c.materialNames.end()) c.materialNames.push_back(name);
+
+        uint32_t face = (uint32_t)c.faceSizes.size();
+        if (!c.runs.empty() && c.runs.back().face == face) c.runs.back().name = id;
+        else c.runs.push_back({ face, id });
+        return true;
+    }
+    if (is("mtllib"))
+    {
+        if (c.mtllib.empty()) c.mtllib = RestOfLine(p, end);
+        return true;
+    }
+    if (is("o") || is("g") || is("s"))
+        return true;
+
+    return false;
+}
+
+static void ParseChunk(ObjChunk& c)
+{
+    // Gruba procena da se izbegne vecina realokacija
+    size_t bytes = (size_t)(c.end - c.begin);
+    c.positions.reserve(bytes / 40 * 3);
+    c.corners.reserve(bytes / 40 * 3);
+
+    const char* p = c.begin;
+    while (p < c.end && c.ok)
+    {
+        const char* lineEnd = (const char*)std::memchr(p, '\n', (size_t)(c.end - p));
+        if (!lineEnd) lineEnd = c.end;
+        c.ok = ParseLine(c, p, lineEnd);
+        p = lineEnd + 1;
+    }
+}
+
+static void LoadMaterials(const std::string& baseDir, const std::string& mtllib,
+                          std::vector<tinyobj::material_t>& materials, std::map<std::string, int>& materialMap)
+{
+    std::istringstream names(mtllib);
+    std::string name;
+    while (names >> name)
+    {
+        std::string text;
+        if (!ReadAsset((baseDir + name).c_str(), text)) continue;
+
+        std::istringstream in(text);
+        std::string warn, err;
+        tinyobj::LoadMtl(&materialMap, &materials, &in, &warn, &err);
+        return;
+    }
+}
+
+struct ObjCornerKey {
+    int32_t v, t, n;
+    bool operator==(const ObjCornerKey& o) const { return v == o.v && t == o.t && n == o.n; }
+};
+
+struct ObjCornerKeyHash {
+    size_t operator()(const ObjCornerKey& c) const
+    {
+        size_t h = (size_t)(uint32_t)c.v * 73856093u;
+        h ^= (size_t)(uint32_t)c.n * 19349663u;
+        h ^= (size_t)(uint32_t)c.t * 83492791u;
+        return h;
+    }
+};
+
+// Verteksi i indeksi po materijalu za jedan deo; duplikati izmedju delova ostaju, ima ih malo
+static void EmitChunk(ObjChunk& c, const std::vector<ObjChunk>& all, size_t materialCount, const glm::vec4& color,
+                      size_t vTotal, size_t tTotal, size_t nTotal)
+{
+    c.buckets.assign(materialCount + 1, {});
+
+    auto resolve = [](int32_t value, bool rel, size_t base, size_t total, int32_t& out) {
+        if (value < 0 && !rel) { out = -1; return true; }
+        int64_t g = rel ? (int64_t)base + value : value;
+        if (g < 0 || g >= (int64_t)total) return false;
+        out = (int32_t)g;
+        return true;
+    };
+
+    // Atributi mogu biti u bilo kom delu; globalni indeks -> (deo, lokalni)
+    auto attrib = [&](size_t ObjChunk::*base, std::vector<float> ObjChunk::*arr, int comps, int32_t g) -> const float* {
+        size_t lo = 0, hi = all.size();
+        while (hi - lo > 1)
+        {
+            size_t mid = (lo + hi) / 2;
+            if (all[mid].*base <= (size_t)g) lo = mid; else hi = mid;
+        }
+        while ((all[lo].*arr).size() / comps <= (size_t)g - all[lo].*base) lo++;
+        return (all[lo].*arr).data() + ((size_t)g - all[lo].*base) * comps;
+    };
+
+    std::unordered_map<ObjCornerKey, uint32_t, ObjCornerKeyHash> seen;
+    seen.reserve(c.corners.size());
+    c.vertices.reserve(c.corners.size() * MESH_STRIDE_FLOATS / 2);
+
+    auto vertexFor = [&](const ObjFaceCorner& fc, uint32_t& outId) -> bool {
+        ObjCornerKey key;
+        if (!resolve(fc.v, fc.rel & 1, c.vBase, vTotal, key.v) || key.v < 0) return false;
+        if (!resolve(fc.t, fc.rel & 2, c.tBase, tTotal, key.t)) return false;
+        if (!resolve(fc.n, fc.rel & 4, c.nBase, nTotal, key.n)) return false;
+
+        auto it = seen.find(key);
+        if (it != seen.end()) { outId = it->second; return true; }
+
+        const float* p = attrib(&ObjChunk::vBase, &ObjChunk::positions, 3, key.v);
+        float u = 0, v = 0, nx = 0, ny = 1, nz = 0;
+        if (key.t >= 0) { const float* t = attrib(&ObjChunk::tBase, &ObjChunk::texcoords, 2, key.t); u = t[0]; v = t[1]; }
+        if (key.n >= 0) { const float* n = attrib(&ObjChunk::nBase, &ObjChunk::normals, 3, key.n); nx = n[0]; ny = n[1]; nz = n[2]; }
+
+        float vert[MESH_STRIDE_FLOATS] = { p[0], p[1], p[2], color.r, color.g, color.b, color.a, u, v, nx, ny, nz };
+        outId = (uint32_t)(c.vertices.size() / MESH_STRIDE_FLOATS);
+        c.vertices.insert(c.vertices.end(), vert, vert + MESH_STRIDE_FLOATS);
+        seen.emplace(key, outId);
+        return true;
+    };
+
+    size_t corner = 0;
+    size_t run = 0;
+    int32_t material = c.startMaterial;
+
+    for (size_t f = 0; f < c.faceSizes.size(); f++)
+    {
+        while (run < c.runs.size() && c.runs[run].face == f)
+        {
+            material = c.materialIds[c.runs[run].name];
+            run++;
+        }
+        std::vector<uint32_t>& target = c.buckets[material + 1];
+
+        int n = c.faceSizes[f];
+        uint32_t id[4];
+        for (int k = 0; k < n; k++)
+            if (!vertexFor(c.corners[corner + k], id[k])) { c.ok = false; return; }
+
+        if (n == 3)
+        {
+            target.insert(target.end(), { id[0], id[1], id[2] });
+        }
+        else
+        {
+            // Kao tinyobj: deli se po kracoj dijagonali
+            auto P = [&](uint32_t i) { const float* q = &c.vertices[(size_t)i * MESH_STRIDE_FLOATS]; return glm::vec3(q[0], q[1], q[2]); };
+            glm::vec3 e02 = P(id[2]) - P(id[0]);
+            glm::vec3 e13 = P(id[3]) - P(id[1]);
+            if (glm::dot(e02, e02) < glm::dot(e13, e13))
+                target.insert(target.end(), { id[0], id[1], id[2], id[0], id[2], id[3] });
+            else
+                target.insert(target.end(), { id[0], id[1], id[3], id[1], id[2], id[3] });
+        }
+        corner += n;
+    }
+}
+
+bool FastParseObjToMeshData(const char* objPath, const glm::vec4& color, MeshData& out)
+{
+    MappedFile file;
+    const char* data = nullptr;
+    size_t size = 0;
+
+    if (const ArchiveEntry* e = gArchive.Find(objPath))
+    {
+        data = (const char*)gArchive.Data(*e);
+        size = (size_t)e->size;
+    }
+    else
+    {
+        if (!file.Open(objPath)) return false;
+        data = (const char*)file.Data();
+        size = file.Size();
+    }
+
+    // Delovi od bar 1 MB, da se male datoteke ne placaju pravljenjem niti
+    size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::max<size_t>(1, std::min(hw, size >> 20));
+
+    std::vector<ObjChunk> chunks(chunkCount);
+    const char* cursor = data;
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        const char* end = (i + 1 == chunkCount) ? data + size : data + size * (i + 1) / chunkCount;
+        if (end < cursor) end = cursor;
+        while (end > data && end < data + size && end[-1] != '\n') end++;
+
+        chunks[i].begin = cursor;
+        chunks[i].end = end;
+        cursor = end;
+    }
+
+    RunParallel(chunkCount, [&](size_t i) { ParseChunk(chunks[i]); });
+
+    std::string mtllib;
+    size_t vTotal = 0, tTotal = 0, nTotal = 0;
+    for (ObjChunk& c : chunks)
+    {
+        if (!c.ok) return false;
+        c.vBase = vTotal; vTotal += c.positions.size() / 3;
+        c.tBase = tTotal; tTotal += c.texcoords.size() / 2;
+        c.nBase = nTotal; nTotal += c.normals.size() / 3;
+        if (mtllib.empty()) mtllib = c.mtllib;
+    }
+
+    std::string baseDir = objPath;
+    auto slash = baseDir.find_last_of("/\\");
+    baseDir = (slash == std::string::npos) ? "" : baseDir.substr(0, slash + 1);
+
+    std::vector<tinyobj::material_t> materials;
+    std::map<std::string, int> materialMap;
+    LoadMaterials(baseDir, mtllib, materials, materialMap);
+
+    // Lica pre prvog usemtl u delu nastavljaju materijal prethodnog dela
+    int32_t material = -1;
+    for (ObjChunk& c : chunks)
+    {
+        c.startMaterial = material;
+        c.materialIds.clear();
+        for (const std::string& name : c.materialNames)
+        {
+            auto it = materialMap.find(name);
+            c.materialIds.push_back((it == materialMap.end() || it->second >= (int)materials.size()) ? -1 : it->second);
+        }
+        if (!c.runs.empty()) material = c.materialIds[c.runs.back().name];
+    }
+
+    RunParallel(chunkCount, [&](size_t i) {
+        EmitChunk(chunks[i], chunks, materials.size(), color, vTotal, tTotal, nTotal);
+    });
+
+    size_t floatTotal = 0, indexTotal = 0;
+    for (const ObjChunk& c : chunks)
+    {
+        if (!c.ok) return false;
+        floatTotal += c.vertices.size();
+        for (const auto& b : c.buckets) indexTotal += b.size();
+    }
+
+    out.vertices.clear();
+    out.indices.clear();
+    out.ranges.clear();
+    out.lods.clear();
+    out.vertices.reserve(floatTotal);
+    out.indices.reserve(indexTotal);
+
+    std::vector<uint32_t> vertexBase(chunkCount);
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        vertexBase[i] = (uint32_t)out.VertexCount();
+        out.vertices.insert(out.vertices.end(), chunks[i].vertices.begin(), chunks[i].vertices.end());
+    }
+
+    // Kanta 0 su lica bez materijala, kanta i+1 je materijal i - isto kao tinyobj put
+    for (size_t b = 0; b <= materials.size(); b++)
+    {
+        MeshRange r;
+        r.first = (uint32_t)out.indices.size();
+        r.materialId = (int32_t)b - 1;
+
+        for (size_t i = 0; i < chunkCount; i++)
+            for (uint32_t idx : chunks[i].buckets[b])
+                out.indices.push_back(idx + vertexBase[i]);
+
+        r.count = (uint32_t)out.indices.size() - r.first;
+        if (r.count == 0) continue;
+
+        if (r.materialId >= 0)
+        {
+            std::strncpy(r.name, materials[r.materialId].name.c_str(), sizeof(r.name) - 1);
+            std::strncpy(r.diffuseTex, materials[r.materialId].diffuse_texname.c_str(), sizeof(r.diffuseTex) - 1);
+        }
+        out.ranges.push_back(r);
+    }
+    return true;
+}
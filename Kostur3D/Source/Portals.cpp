@@ -0,0 +1,171 @@
+#include "Header/Portals.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Ogranicava put kroz portale (ciklusi soba-soba-spolja)
+static constexpr int MAX_PORTAL_DEPTH = 8;
+// Ovoliko blizu portala (near ravan je 0.1) deo otvora ispada iza near ravni,
+// pa se kroz portal gleda bez suzavanja
+static constexpr float PASS_DISTANCE = 0.3f;
+
+int PortalGraph::AddRoom(const std::string& name, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    Room r;
+    r.name = name;
+    r.boundsMin = boundsMin;
+    r.boundsMax = boundsMax;
+    rooms.push_back(r);
+    visible.assign(rooms.size(), 1);
+    return (int)rooms.size() - 1;
+}
+
+void PortalGraph::AddPortal(int a, int b, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    Portal p;
+    p.a = a;
+    p.b = b;
+    p.boundsMin = boundsMin;
+    p.boundsMax = boundsMax;
+
+    // Normala je po osi na kojoj je portal najtanji
+    glm::vec3 size = boundsMax - boundsMin;
+    p.axis = (size.x <= size.y && size.x <= size.z) ? 0 : (size.y <= size.z ? 1 : 2);
+    p.plane = (boundsMin[p.axis] + boundsMax[p.axis]) * 0.5f;
+
+    // Strana se odredjuje po manjoj sobi (veca moze biti "spolja" i obuhvatati portal)
+    const Room& ra = rooms[a];
+    const Room& rb = rooms[b];
+    float extA = ra.boundsMax[p.axis] - ra.boundsMin[p.axis];
+    float extB = rb.boundsMax[p.axis] - rb.boundsMin[p.axis];
+    if (extB <= extA)
+        p.sideB = ((rb.boundsMin[p.axis] + rb.boundsMax[p.axis]) * 0.5f > p.plane) ? 1.0f : -1.0f;
+    else
+        p.sideB = ((ra.boundsMin[p.axis] + ra.boundsMax[p.axis]) * 0.5f > p.plane) ? -1.0f : 1.0f;
+
+    int u = (p.axis + 1) % 3, v = (p.axis + 2) % 3;
+    const float us[4] = { boundsMin[u], boundsMax[u], boundsMax[u], boundsMin[u] };
+    const float vs[4] = { boundsMin[v], boundsMin[v], boundsMax[v], boundsMax[v] };
+    for (int i = 0; i < 4; i++)
+    {
+        p.corners[i][p.axis] = p.plane;
+        p.corners[i][u] = us[i];
+        p.corners[i][v] = vs[i];
+    }
+
+    portals.push_back(p);
+    onPath.assign(portals.size(), 0);
+    rooms[a].portals.push_back((int)portals.size() - 1);
+    rooms[b].portals.push_back((int)portals.size() - 1);
+}
+
+int PortalGraph::RoomAt(const glm::vec3& p) const
+{
+    for (size_t i = 0; i < rooms.size(); i++)
+    {
+        const Room& r = rooms[i];
+        if (p.x >= r.boundsMin.x && p.y >= r.boundsMin.y && p.z >= r.boundsMin.z &&
+            p.x <= r.boundsMax.x && p.y <= r.boundsMax.y && p.z <= r.boundsMax.z)
+            return (int)i;
+    }
+    return -1;
+}
+
+void PortalGraph::Update(const glm::vec3& eyePos, const glm::mat4& VP)
+{
+    eye = eyePos;
+    viewProj = VP;
+    lastPortalsPassed = 0;
+
+    lastEyeRoom = RoomAt(eye);
+    if (lastEyeRoom < 0)
+    {
+        visible.assign(rooms.size(), 1);
+        lastVisibleRooms = rooms.size();
+        return;
+    }
+
+    visible.assign(rooms.size(), 0);
+    Visit(lastEyeRoom, Rect(), 0);
+
+    lastVisibleRooms = 0;
+    for (uint8_t v : visible)
+        lastVisibleRooms += v;
+}
+
+void PortalGraph::Visit(int room, const Rect& view, int depth)
+{
+    visible[room] = 1;
+    if (depth >= MAX_PORTAL_DEPTH) return;
+
+    for (int pi : rooms[room].portals)
+    {
+        if (onPath[pi]) continue;
+        const Portal& p = portals[pi];
+        int next = (p.a == room) ? p.b : p.a;
+
+        // Pozitivno kad je kamera vec s one strane portala - tada se kroz njega gleda unazad
+        float side = (p.a == room) ? p.sideB : -p.sideB;
+        float dist = (eye[p.axis] - p.plane) * side;
+        if (dist > 1e-3f) continue;
+
+        Rect r;
+        glm::vec3 nearest = glm::clamp(eye, p.boundsMin, p.boundsMax);
+        if (glm::length(eye - nearest) < PASS_DISTANCE)
+            r = view;
+        else if (!ProjectPortal(p, r))
+            continue;
+
+        r.x0 = std::max(r.x0, view.x0);
+        r.y0 = std::max(r.y0, view.y0);
+        r.x1 = std::min(r.x1, view.x1);
+        r.y1 = std::min(r.y1, view.y1);
+        if (r.Empty()) continue;
+
+        lastPortalsPassed++;
+        onPath[pi] = 1;
+        Visit(next, r, depth + 1);
+        onPath[pi] = 0;
+    }
+}
+
+bool PortalGraph::ProjectPortal(const Portal& p, Rect& out) const
+{
+    glm::vec4 in[4];
+    for (int i = 0; i < 4; i++)
+        in[i] = viewProj * glm::vec4(p.corners[i], 1.0f);
+
+    // Odsecanje near ravni (z + w >= 0) - tacke iza kamere bi se projektovale naopako
+    glm::vec4 poly[8];
+    int n = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        const glm::vec4& c = in[i];
+        const glm::vec4& d = in[(i + 1) % 4];
+        float dc = c.z + c.w, dd = d.z + d.w;
+        if (dc >= 0.0f) poly[n++] = c;
+        if ((dc >= 0.0f) != (dd >= 0.0f))
+            poly[n++] = c + (d - c) * (dc / (dc - dd));
+    }
+    if (n == 0) return false;
+
+    out.x0 = out.y0 = 1e30f;
+    out.x1 = out.y1 = -1e30f;
+    for (int i = 0; i < n; i++)
+    {
+        float w = std::max(poly[i].w, 1e-6f);
+        float x = poly[i].x / w, y = poly[i].y / w;
+        out.x0 = std::min(out.x0, x);
+        out.y0 = std::min(out.y0, y);
+        out.x1 = std::max(out.x1, x);
+        out.y1 = std::max(out.y1, y);
+    }
+    return true;
+}
+
+void PortalGraph::PrintStats() const
+{
+    std::cout << "[PORTAL] kamera u " << (lastEyeRoom >= 0 ? rooms[lastEyeRoom].name : std::string("(nijednoj sobi)"))
+              << ", vidljivo soba " << lastVisibleRooms << " od " << rooms.size()
+              << ", prolaza kroz portale " << lastPortalsPassed << "\n";
+}
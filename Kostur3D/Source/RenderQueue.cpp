@@ -0,0 +1,140 @@
+#include "Header/RenderQueue.h"
+#include "Header/Frustum.h"
+#include <algorithm>
+#include <iostream>
+
+// Dalje od ovoga kljuc vise ne razlikuje dubinu (soba je oko 20 m)
+static constexpr float SORT_DEPTH_RANGE = 64.0f;
+
+static constexpr uint64_t DEPTH_BITS = 24;
+static constexpr uint64_t ID_BITS = 12;
+static constexpr uint64_t SHADER_BITS = 6;
+
+uint64_t MakeSortKey(RenderPass pass, bool blended, uint32_t shader, uint32_t texture, uint32_t mesh, float depth)
+{
+    const uint64_t depthMax = (1ull << DEPTH_BITS) - 1;
+    float t = std::min(std::max(depth / SORT_DEPTH_RANGE, 0.0f), 1.0f);
+    uint64_t d = (uint64_t)(t * (float)depthMax);
+
+    uint64_t s = shader & ((1u << SHADER_BITS) - 1);
+    uint64_t tex = texture & ((1u << ID_BITS) - 1);
+    uint64_t m = mesh & ((1u << ID_BITS) - 1);
+
+    uint64_t key = (uint64_t)pass << 62;
+    if (!blended)
+    {
+        key |= s << (61 - SHADER_BITS);
+        key |= tex << (61 - SHADER_BITS - ID_BITS);
+        key |= m << (61 - SHADER_BITS - 2 * ID_BITS);
+        key |= d << (61 - SHADER_BITS - 2 * ID_BITS - DEPTH_BITS);
+    }
+    else
+    {
+        key |= 1ull << 61;
+        key |= (depthMax - d) << (61 - DEPTH_BITS);
+        key |= s << (61 - DEPTH_BITS - SHADER_BITS);
+        key |= tex << (61 - DEPTH_BITS - SHADER_BITS - ID_BITS);
+        key |= m << (61 - DEPTH_BITS - SHADER_BITS - 2 * ID_BITS);
+    }
+    return key;
+}
+
+static bool SameState(const DrawPacket& a, const DrawPacket& b)
+{
+    return a.kind == b.kind && a.tex == b.tex && a.mesh == b.mesh &&
+           a.state.cull == b.state.cull && a.state.depthTest == b.state.depthTest &&
+           a.state.depthWrite == b.state.depthWrite && a.state.polygonOffset == b.state.polygonOffset &&
+           a.state.unlit == b.state.unlit && a.state.emissive == b.state.emissive;
+}
+
+// Grupe uzastopnih paketa bez ikakve promene stanja izmedju njih
+template <typename Get>
+static size_t CountBatches(size_t n, Get get)
+{
+    size_t batches = 0;
+    for (size_t i = 0; i < n; i++)
+        if (i == 0 || !SameState(get(i - 1), get(i)))
+            batches++;
+    return batches;
+}
+
+void RenderQueue::Cull(const Frustum& f, const std::vector<uint8_t>& visibleRooms)
+{
+    // Po paketu: 1 ostaje, 0 se izbacuje
+    cullVisible.assign(packets.size(), 1);
+    cullX.clear(); cullY.clear(); cullZ.clear(); cullR.clear();
+    cullIndex.clear();
+
+    size_t roomCulled = 0;
+    for (size_t i = 0; i < packets.size(); i++)
+    {
+        const DrawPacket& p = packets[i];
+        if (p.room >= 0 && (size_t)p.room < visibleRooms.size() && !visibleRooms[p.room])
+        {
+            cullVisible[i] = 0;
+            roomCulled++;
+            continue;
+        }
+        if (p.boundsRadius < 0.0f) continue;
+        cullX.push_back(p.boundsCenter.x);
+        cullY.push_back(p.boundsCenter.y);
+        cullZ.push_back(p.boundsCenter.z);
+        cullR.push_back(p.boundsRadius);
+        cullIndex.push_back((uint32_t)i);
+    }
+
+    cullSphere.resize(cullIndex.size());
+    CullSpheres(f, cullX.data(), cullY.data(), cullZ.data(), cullR.data(), cullIndex.size(), cullSphere.data());
+
+    // Sfera je labava za duge zidove i ploce; kutija odbacuje jos ponesto uz ivice kadra
+    size_t culled = 0;
+    for (size_t k = 0; k < cullIndex.size(); k++)
+    {
+        const DrawPacket& p = packets[cullIndex[k]];
+        if (cullSphere[k] && BoxInFrustum(f, p.boundsCenter, p.boundsExtent)) continue;
+        cullVisible[cullIndex[k]] = 0;
+        culled++;
+    }
+
+    // Sabijanje uz ocuvan redosled snimanja (od njega zavisi redosled jednakih kljuceva)
+    if (culled || roomCulled)
+    {
+        size_t out = 0;
+        for (size_t i = 0; i < packets.size(); i++)
+        {
+            if (!cullVisible[i]) continue;
+            if (out != i) packets[out] = packets[i];
+            out++;
+        }
+        packets.resize(out);
+    }
+
+    lastTested = cullIndex.size();
+    lastCulled = culled;
+    lastRoomCulled = roomCulled;
+}
+
+void RenderQueue::Sort()
+{
+    order.resize(packets.size());
+    for (size_t i = 0; i < packets.size(); i++)
+        order[i] = { packets[i].key, (uint32_t)i };
+    std::sort(order.begin(), order.end());
+
+    lastPackets = packets.size();
+    lastUnsortedBatches = CountBatches(packets.size(), [&](size_t i) -> const DrawPacket& { return packets[i]; });
+    lastBatches = CountBatches(packets.size(), [&](size_t i) -> const DrawPacket& { return (*this)[i]; });
+}
+
+void RenderQueue::Clear()
+{
+    packets.clear();
+    order.clear();
+}
+
+void RenderQueue::PrintStats() const
+{
+    std::cout << "[QUEUE] " << lastPackets << " poziva, promena stanja " << lastBatches
+              << " (bez sortiranja " << lastUnsortedBatches << "), van kadra " << lastCulled
+              << " od " << lastTested << ", u nevidljivim sobama " << lastRoomCulled << "\n";
+}
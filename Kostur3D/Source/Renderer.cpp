@@ -1,49 +1,160 @@
 #include "Header/Renderer.h"
+#include "Header/MeshBuilders.h"
+#include "Header/GLState.h"
+#include "Header/SamplerCache.h"
 #include "Util.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <iostream>
 
 static constexpr GLsizei STRIDE_FLOATS = 12;
 static constexpr GLsizei STRIDE_BYTES  = STRIDE_FLOATS * (GLsizei)sizeof(float);
 
-static GLuint PreprocessTexture(const char* filepath)
+static constexpr GLuint FRAME_BINDING = 0;
+static constexpr GLuint DRAW_BINDING = 1;
+// Scena ima par stotina poziva po frejmu (oko 256 B po Draw bloku) i stotinak instanci
+static constexpr size_t STREAM_FRAME_BYTES = (size_t)1 << 20;
+
+struct PackedVertex {
+    uint16_t px, py, pz, pw;
+    uint32_t normal;
+    uint16_t u, v;
+};
+
+static_assert(sizeof(PackedVertex) == 16, "packed vertex layout");
+
+static uint32_t PackNormal1010102(float x, float y, float z)
 {
-    GLuint tex = loadImageToTexture(filepath);
-    if (!tex) return 0;
+    auto q = [](float f) -> uint32_t {
+        f = glm::clamp(f, -1.0f, 1.0f);
+        int32_t i = (int32_t)std::lround(f * 511.0f);
+        return (uint32_t)i & 0x3FFu;
+    };
+    return q(x) | (q(y) << 10) | (q(z) << 20);
+}
 
-    glBindTexture(GL_TEXTURE_2D, tex);
+static void ResetMesh(MeshGL& m)
+{
+    gGLState.DeleteVertexArray(m.vao);
+    gGLState.DeleteBuffer(m.vbo);
+    gGLState.DeleteBuffer(m.ebo);
+    m.indexCount = 0;
+    for (SubMesh& p : m.parts)
+        gTextures.Release(p.tex);
+    m.parts.clear();
+    m.lods.clear();
+    m.isPlaceholder = false;
+    m.format = VertexFormat::Float;
+    m.posScale = glm::vec3(1.0f);
+    m.posOffset = glm::vec3(0.0f);
+}
 
-    glGenerateMipmap(GL_TEXTURE_2D);
+static void UploadIndices(MeshGL& m, const uint32_t* indices, size_t indexCount)
+{
+    gGLState.BindVertexArray(m.vao);
+    glGenBuffers(1, &m.ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m.ebo);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    if (m.vertexCount <= 65536)
+    {
+        std::vector<uint16_t> narrow(indices, indices + indexCount);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indexCount * sizeof(uint16_t)), narrow.data(), GL_STATIC_DRAW);
+        m.indexType = GL_UNSIGNED_SHORT;
+    }
+    else
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indexCount * sizeof(uint32_t)), indices, GL_STATIC_DRAW);
+        m.indexType = GL_UNSIGNED_INT;
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gGLState.BindVertexArray(0);
+    m.indexCount = (GLsizei)indexCount;
+}
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    return tex;
+static void ComputeBounds(MeshGL& m, const float* data, size_t floatCount)
+{
+    size_t n = floatCount / STRIDE_FLOATS;
+    glm::vec3 bmin(0.0f), bmax(0.0f);
+    for (size_t i = 0; i < n; i++)
+    {
+        glm::vec3 p(data[i * STRIDE_FLOATS + 0], data[i * STRIDE_FLOATS + 1], data[i * STRIDE_FLOATS + 2]);
+        bmin = (i == 0) ? p : glm::min(bmin, p);
+        bmax = (i == 0) ? p : glm::max(bmax, p);
+    }
+    m.boundsMin = bmin;
+    m.boundsMax = bmax;
+
+    // Tacan poluprecnik oko centra kutije (manji od pola dijagonale)
+    glm::vec3 c = (bmin + bmax) * 0.5f;
+    float r2 = 0.0f;
+    for (size_t i = 0; i < n; i++)
+    {
+        glm::vec3 p(data[i * STRIDE_FLOATS + 0], data[i * STRIDE_FLOATS + 1], data[i * STRIDE_FLOATS + 2]);
+        glm::vec3 d = p - c;
+        r2 = glm::max(r2, glm::dot(d, d));
+    }
+    m.sphereCenter = c;
+    m.sphereRadius = std::sqrt(r2);
+}
+
+void SetMeshBounds(MeshGL& m, const glm::vec3& bmin, const glm::vec3& bmax)
+{
+    m.boundsMin = bmin;
+    m.boundsMax = bmax;
+    m.sphereCenter = (bmin + bmax) * 0.5f;
+    m.sphereRadius = glm::length(bmax - bmin) * 0.5f;
+}
+
+static void DrawTriangles(const MeshGL& m, int lod = 0)
+{
+    if (m.ebo && lod > 0 && lod < (int)m.lods.size())
+    {
+        size_t indexSize = (m.indexType == GL_UNSIGNED_SHORT) ? sizeof(uint16_t) : sizeof(uint32_t);
+        glDrawElements(GL_TRIANGLES, m.lods[lod].count, m.indexType, (void*)(m.lods[lod].first * indexSize));
+    }
+    else if (m.ebo)
+        glDrawElements(GL_TRIANGLES, m.indexCount, m.indexType, (void*)0);
+    else
+        glDrawArrays(GL_TRIANGLES, 0, m.vertexCount);
 }
 
+
 bool Renderer::Init(GLuint shaderProgram, const char* overlayPath)
 {
     shader = shaderProgram;
-    glUseProgram(shader);
-
-    uM = glGetUniformLocation(shader, "uM");
-    uV = glGetUniformLocation(shader, "uV");
-    uP = glGetUniformLocation(shader, "uP");
-    uUseTex = glGetUniformLocation(shader, "useTex");
-    uTransparent = glGetUniformLocation(shader, "transparent");
-    uTint = glGetUniformLocation(shader, "uTint");
+    gGLState.UseProgram(shader);
+
+    // Sve lokacije se traze jednom, ovde; u frejmu nema glGetUniformLocation
     uTex  = glGetUniformLocation(shader, "uTex");
+    uGlyphTex = glGetUniformLocation(shader, "uGlyphTex");
+
+    // sampler2D i sampler2DArray ne smeju deliti jedinicu
+    gGLState.Uniform1i(uTex, 0);
+    gGLState.Uniform1i(uGlyphTex, 1);
 
-    glUniform1i(uTex, 0);
+    // 3.3 nema layout(binding), tacke se vezuju ovde
+    GLuint frameBlock = glGetUniformBlockIndex(shader, "Frame");
+    GLuint drawBlock = glGetUniformBlockIndex(shader, "Draw");
+    if (frameBlock == GL_INVALID_INDEX || drawBlock == GL_INVALID_INDEX)
+    {
+        std::cout << "Shader nema uniform blokove Frame/Draw\n";
+        return false;
+    }
+    glUniformBlockBinding(shader, frameBlock, FRAME_BINDING);
+    glUniformBlockBinding(shader, drawBlock, DRAW_BINDING);
 
+    CreateStreamBuffer();
     CreateCube();
 
-    overlayTex = PreprocessTexture(overlayPath);
+    gSamplers.Init();
 
-    centerTex = PreprocessTexture("res/center.png");
+    overlayTex = gTextures.Load(overlayPath);
+    centerTex = gTextures.Load("res/center.png");
 
     std::vector<float> c;
     c.reserve(4 * STRIDE_FLOATS);
@@ -89,13 +200,15 @@ bool Renderer::Init(GLuint shaderProgram, const char* overlayPath)
     return true;
 }
 
+void Renderer::DestroyMesh(MeshGL& m)
+{
+    ResetMesh(m);
+    m = MeshGL{};
+}
+
 void Renderer::Destroy()
 {
-    auto kill = [](MeshGL& m){
-        if (m.vbo) glDeleteBuffers(1, &m.vbo);
-        if (m.vao) glDeleteVertexArrays(1, &m.vao);
-        m = MeshGL{};
-    };
+    auto kill = [this](MeshGL& m){ DestroyMesh(m); };
 
     kill(cube);
     kill(basin);
@@ -105,24 +218,35 @@ void Renderer::Destroy()
     kill(centerQuad);
     kill(screenQuad);
 
-    if (overlayTex) glDeleteTextures(1, &overlayTex);
-    overlayTex = 0;
+    for (OcclusionQuery& q : occlusion)
+        glDeleteQueries(1, &q.query);
+    occlusion.clear();
+
+    // Ime bafera ne sme ostati u senci stanja
+    gGLState.Invalidate();
+    stream.Destroy();
+    lastDrawValid = false;
 
-    if (centerTex) glDeleteTextures(1, &centerTex);
-    centerTex = 0;
+    gTextures.Release(overlayTex);
+    gTextures.Release(centerTex);
+    gSamplers.Destroy();
 }
 
 void Renderer::CreateFromFloats(MeshGL& m, const std::vector<float>& data, bool cubeFans)
 {
-    if (m.vao) glDeleteVertexArrays(1, &m.vao);
-    if (m.vbo) glDeleteBuffers(1, &m.vbo);
+    CreateFromFloats(m, data.data(), data.size(), cubeFans);
+}
+
+void Renderer::CreateFromFloats(MeshGL& m, const float* data, size_t floatCount, bool cubeFans)
+{
+    ResetMesh(m);
 
     glGenVertexArrays(1, &m.vao);
-    glBindVertexArray(m.vao);
+    gGLState.BindVertexArray(m.vao);
 
     glGenBuffers(1, &m.vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m.vbo);
-    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(data.size() * sizeof(float)), data.data(), GL_STATIC_DRAW);
+    gGLState.BindBuffer(GL_ARRAY_BUFFER, m.vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(floatCount * sizeof(float)), data, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, STRIDE_BYTES, (void*)0);
     glEnableVertexAttribArray(0);
@@ -136,165 +260,444 @@ void Renderer::CreateFromFloats(MeshGL& m, const std::vector<float>& data, bool
     glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, STRIDE_BYTES, (void*)(9 * sizeof(float)));
     glEnableVertexAttribArray(3);
 
-    glBindVertexArray(0);
+    gGLState.BindVertexArray(0);
 
-    m.vertexCount = (GLsizei)(data.size() / STRIDE_FLOATS);
+    m.vertexCount = (GLsizei)(floatCount / STRIDE_FLOATS);
     m.isCubeFans = cubeFans;
+    ComputeBounds(m, data, floatCount);
 }
 
-void Renderer::CreateCube()
+void Renderer::CreateIndexed(MeshGL& m, const float* data, size_t floatCount, const uint32_t* indices, size_t indexCount)
+{
+    CreateFromFloats(m, data, floatCount, false);
+    UploadIndices(m, indices, indexCount);
+}
+
+void Renderer::CreatePacked(MeshGL& m, const float* data, size_t floatCount, const uint32_t* indices, size_t indexCount)
 {
-    float cubeVerts[] =
+    ResetMesh(m);
+
+    size_t n = floatCount / STRIDE_FLOATS;
+
+    ComputeBounds(m, data, floatCount);
+    glm::vec3 bmin = m.boundsMin;
+    glm::vec3 extent = m.boundsMax - bmin;
+
+    std::vector<PackedVertex> packed(n);
+    for (size_t i = 0; i < n; i++)
     {
-        // Front
-         0.1f, 0.1f, 0.1f,  1,1,1,1,  0,0,   0,0, 1,
-        -0.1f, 0.1f, 0.1f,  1,1,1,1,  1,0,   0,0, 1,
-        -0.1f,-0.1f, 0.1f,  1,1,1,1,  1,1,   0,0, 1,
-         0.1f,-0.1f, 0.1f,  1,1,1,1,  0,1,   0,0, 1,
-
-        // Left
-        -0.1f, 0.1f, 0.1f,  1,1,1,1,  0,0,  -1,0,0,
-        -0.1f, 0.1f,-0.1f,  1,1,1,1,  1,0,  -1,0,0,
-        -0.1f,-0.1f,-0.1f,  1,1,1,1,  1,1,  -1,0,0,
-        -0.1f,-0.1f, 0.1f,  1,1,1,1,  0,1,  -1,0,0,
-
-        // Bottom
-         0.1f,-0.1f, 0.1f,  1,1,1,1,  0,0,   0,-1,0,
-        -0.1f,-0.1f, 0.1f,  1,1,1,1,  1,0,   0,-1,0,
-        -0.1f,-0.1f,-0.1f,  1,1,1,1,  1,1,   0,-1,0,
-         0.1f,-0.1f,-0.1f,  1,1,1,1,  0,1,   0,-1,0,
-
-        // Top
-         0.1f, 0.1f, 0.1f,  1,1,1,1,  0,0,   0,1,0,
-         0.1f, 0.1f,-0.1f,  1,1,1,1,  1,0,   0,1,0,
-        -0.1f, 0.1f,-0.1f,  1,1,1,1,  1,1,   0,1,0,
-        -0.1f, 0.1f, 0.1f,  1,1,1,1,  0,1,   0,1,0,
-
-        // Right
-         0.1f, 0.1f, 0.1f,  1,1,1,1,  0,0,   1,0,0,
-         0.1f,-0.1f, 0.1f,  1,1,1,1,  1,0,   1,0,0,
-         0.1f,-0.1f,-0.1f,  1,1,1,1,  1,1,   1,0,0,
-         0.1f, 0.1f,-0.1f,  1,1,1,1,  0,1,   1,0,0,
-
-        // Back
-         0.1f, 0.1f,-0.1f,  1,1,1,1,  0,0,  0,0,-1,
-         0.1f,-0.1f,-0.1f,  1,1,1,1,  1,0,  0,0,-1,
-        -0.1f,-0.1f,-0.1f,  1,1,1,1,  1,1,  0,0,-1,
-        -0.1f, 0.1f,-0.1f,  1,1,1,1,  0,1,  0,0,-1,
-    };
+        const float* v = data + i * STRIDE_FLOATS;
+        PackedVertex& o = packed[i];
+
+        auto qpos = [](float p, float lo, float ext) -> uint16_t {
+            if (ext <= 0.0f) return 0;
+            float t = glm::clamp((p - lo) / ext, 0.0f, 1.0f);
+            return (uint16_t)std::lround(t * 65535.0f);
+        };
+        o.px = qpos(v[0], bmin.x, extent.x);
+        o.py = qpos(v[1], bmin.y, extent.y);
+        o.pz = qpos(v[2], bmin.z, extent.z);
+        o.pw = 0;
+
+        o.u = glm::packHalf1x16(v[7]);
+        o.v = glm::packHalf1x16(v[8]);
+        o.normal = PackNormal1010102(v[9], v[10], v[11]);
+    }
+
+    glGenVertexArrays(1, &m.vao);
+    gGLState.BindVertexArray(m.vao);
+
+    glGenBuffers(1, &m.vbo);
+    gGLState.BindBuffer(GL_ARRAY_BUFFER, m.vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(packed.size() * sizeof(PackedVertex)), packed.data(), GL_STATIC_DRAW);
+
+    const GLsizei stride = (GLsizei)sizeof(PackedVertex);
+
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(PackedVertex, px));
+    glEnableVertexAttribArray(0);
+
+    glDisableVertexAttribArray(1);
 
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, u));
+    glEnableVertexAttribArray(2);
+
+    glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(PackedVertex, normal));
+    glEnableVertexAttribArray(3);
+
+    gGLState.BindVertexArray(0);
+
+    m.vertexCount = (GLsizei)n;
+    m.isCubeFans = false;
+    m.format = VertexFormat::Packed;
+    m.posScale = extent;
+    m.posOffset = bmin;
+    if (n > 0) m.color = glm::vec4(data[3], data[4], data[5], data[6]);
+
+    UploadIndices(m, indices, indexCount);
+}
+
+void Renderer::CreateMesh(MeshGL& m, VertexFormat format, const float* data, size_t floatCount, const uint32_t* indices, size_t indexCount)
+{
+    if (format == VertexFormat::Packed)
+        CreatePacked(m, data, floatCount, indices, indexCount);
+    else
+        CreateIndexed(m, data, floatCount, indices, indexCount);
+}
+
+void Renderer::ApplyMeshFormat(const MeshGL& m)
+{
+    if (m.format == VertexFormat::Packed)
+        glVertexAttrib4f(1, m.color.r, m.color.g, m.color.b, m.color.a);
+
+    draw.posScale = glm::vec4(m.posScale, 0.0f);
+    draw.posOffset = glm::vec4(m.posOffset, 0.0f);
+}
+
+void Renderer::CreateStreamBuffer()
+{
+    GLint align = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+    uniformAlign = align > 0 ? (size_t)align : 256;
+
+    stream.Init(STREAM_FRAME_BYTES);
+    lastDrawValid = false;
+}
+
+void Renderer::SetDraw(const glm::mat4& M, const glm::vec4& tint, int useTex, DrawMode mode)
+{
+    draw.M = M;
+    draw.tint = tint;
+    draw.flags.x = useTex;
+    draw.flags.z = mode;
+}
+
+bool Renderer::CommitDraw()
+{
+    // Npr. delovi SubMeshes bez promene teksture - vec vezan opseg vazi
+    if (lastDrawValid && std::memcmp(&draw, &lastDraw, sizeof(DrawUniforms)) == 0)
+    {
+        drawReuses++;
+        return true;
+    }
+
+    StreamAlloc a = stream.Alloc(sizeof(DrawUniforms), uniformAlign);
+    if (!a.Valid()) return false;
+    std::memcpy(a.ptr, &draw, sizeof(DrawUniforms));
+    stream.Commit(a);
+    gGLState.BindUniformRange(DRAW_BINDING, stream.Buffer(), a.offset, sizeof(DrawUniforms));
+
+    lastDraw = draw;
+    lastDrawValid = true;
+    drawUploads++;
+    return true;
+}
+
+void Renderer::CreateCube()
+{
     std::vector<float> v;
-    v.assign(cubeVerts, cubeVerts + (sizeof(cubeVerts) / sizeof(float)));
+    BuildCube(v);
     CreateFromFloats(cube, v, true);
     cube.vertexCount = 24;
     cube.isCubeFans = true;
+
+    // Lepeze stranica kao trouglovi, da cela kocka bude jedan poziv
+    uint32_t idx[36];
+    for (uint32_t f = 0; f < 6; f++)
+    {
+        const uint32_t fan[6] = { 0, 1, 2, 0, 2, 3 };
+        for (uint32_t i = 0; i < 6; i++)
+            idx[f * 6 + i] = f * 4 + fan[i];
+    }
+    UploadIndices(cube, idx, 36);
 }
 
-void Renderer::SetCommonUniforms(const glm::mat4& V, const glm::mat4& P)
+void Renderer::SetCommonUniforms(const glm::mat4& V, const glm::mat4& P, float viewportHeight)
 {
-    glUseProgram(shader);
-    glUniformMatrix4fv(uV, 1, GL_FALSE, glm::value_ptr(V));
-    glUniformMatrix4fv(uP, 1, GL_FALSE, glm::value_ptr(P));
+    frame.V = V;
+    frame.P = P;
+
+    // Polozaj kamere iz view matrice (inverz rotacije puta translacija)
+    glm::mat3 R(V);
+    lodEye = -(glm::transpose(R) * glm::vec3(V[3]));
+    lodPixelsPerUnit = P[1][1] * viewportHeight * 0.5f;
+    frustum = ExtractFrustum(P * V);
 }
 
-void Renderer::DrawCube(const glm::mat4& M, const glm::vec4& tint, bool transparentFlag)
+void Renderer::SetLight(int index, const glm::vec3& pos, const glm::vec3& color, float power)
+{
+    if (index == 0)
+    {
+        frame.lightPos = glm::vec4(pos, 1.0f);
+        frame.lightColor = glm::vec4(color, power);
+    }
+    else
+    {
+        frame.lightPos2 = glm::vec4(pos, 1.0f);
+        frame.lightColor2 = glm::vec4(color, power);
+    }
+}
+
+void Renderer::SetAmbient(float ambient)
 {
-    glUniform1i(uUseTex, 0);
-    glUniform1i(uTransparent, transparentFlag ? 1 : 0);
-    glUniform4f(uTint, tint.r, tint.g, tint.b, tint.a);
-    glUniformMatrix4fv(uM, 1, GL_FALSE, glm::value_ptr(M));
+    frame.ambient = glm::vec4(ambient, 0.0f, 0.0f, 0.0f);
+}
 
-    glBindVertexArray(cube.vao);
-    for (int i = 0; i < 6; ++i)
-        glDrawArrays(GL_TRIANGLE_FAN, i * 4, 4);
-    glBindVertexArray(0);
+// Granicna sfera u svetu; vraca najvecu skalu iz M
+static float WorldSphere(const MeshGL& m, const glm::mat4& M, glm::vec3& center, float& radius)
+{
+    float scale = glm::max(glm::length(glm::vec3(M[0])), glm::max(glm::length(glm::vec3(M[1])), glm::length(glm::vec3(M[2]))));
+    center = glm::vec3(M * glm::vec4(m.sphereCenter, 1.0f));
+    radius = m.sphereRadius * scale;
+    return scale;
 }
 
-void Renderer::DrawMeshTriangles(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint, bool transparentFlag)
+// Kutija poravnata sa osama koja obuhvata lokalnu kutiju posle M
+static void WorldBox(const MeshGL& m, const glm::mat4& M, glm::vec3& center, glm::vec3& extent)
 {
-    glUniform1i(uUseTex, 0);
-    glUniform1i(uTransparent, transparentFlag ? 1 : 0);
-    glUniform4f(uTint, tint.r, tint.g, tint.b, tint.a);
-    glUniformMatrix4fv(uM, 1, GL_FALSE, glm::value_ptr(M));
+    glm::vec3 half = (m.boundsMax - m.boundsMin) * 0.5f;
+    center = glm::vec3(M * glm::vec4((m.boundsMin + m.boundsMax) * 0.5f, 1.0f));
+    extent = glm::abs(glm::vec3(M[0])) * half.x + glm::abs(glm::vec3(M[1])) * half.y + glm::abs(glm::vec3(M[2])) * half.z;
+}
 
-    glBindVertexArray(m.vao);
-    glDrawArrays(GL_TRIANGLES, 0, m.vertexCount);
-    glBindVertexArray(0);
+int Renderer::SelectLod(const MeshGL& m, const glm::mat4& M) const
+{
+    if (m.lods.size() < 2 || lodPixelsPerUnit <= 0.0f) return 0;
+
+    glm::vec3 center;
+    float radius;
+    float scale = WorldSphere(m, M, center, radius);
+
+    // Najbliza tacka granicne sfere; unutar sfere uvek pun model
+    float dist = glm::length(center - lodEye) - radius;
+    if (dist <= 1e-3f) return 0;
+
+    // Greska nivoa projektovana na ekran, u pikselima
+    float pixelsPerUnit = lodPixelsPerUnit / dist;
+    int best = 0;
+    for (int i = 1; i < (int)m.lods.size(); i++)
+        if (m.lods[i].error * scale * pixelsPerUnit <= lodMaxPixelError)
+            best = i;
+    return best;
 }
 
-void Renderer::DrawOverlay()
+float Renderer::ProjectedPixels(const MeshGL& m, const glm::mat4& M) const
 {
-    glUseProgram(shader);
+    const float full = 1e6f;
+    if (lodPixelsPerUnit <= 0.0f) return full;
 
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
+    glm::vec3 center;
+    float radius;
+    WorldSphere(m, M, center, radius);
 
-    glm::mat4 I(1.0f);
-    glUniformMatrix4fv(uV, 1, GL_FALSE, glm::value_ptr(I));
-    glUniformMatrix4fv(uP, 1, GL_FALSE, glm::value_ptr(I));
-    glUniformMatrix4fv(uM, 1, GL_FALSE, glm::value_ptr(I));
+    float dist = glm::length(center - lodEye) - radius;
+    if (dist <= 1e-3f) return full;
+    return 2.0f * radius * lodPixelsPerUnit / dist;
+}
 
-    glUniform1i(uUseTex, 1);
-    glUniform1i(uTransparent, 1);
-    glUniform4f(uTint, 1.0f, 1.0f, 1.0f, 0.4f);
+int Renderer::CreateOcclusionQuery(const std::string& name)
+{
+    OcclusionQuery q;
+    q.name = name;
+    glGenQueries(1, &q.query);
+    occlusion.push_back(q);
+    return (int)occlusion.size() - 1;
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, overlayTex);
+bool Renderer::OcclusionTest(int id, const MeshGL& m, const glm::mat4& M)
+{
+    OcclusionQuery& q = occlusion[id];
 
-    glBindVertexArray(overlayQuad.vao);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+    // Rezultat nekog od proslih frejmova, samo ako je vec stigao
+    if (q.pending)
+    {
+        GLuint ready = 0;
+        glGetQueryObjectuiv(q.query, GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (ready)
+        {
+            GLuint anySamples = 0;
+            glGetQueryObjectuiv(q.query, GL_QUERY_RESULT, &anySamples);
+            q.visible = anySamples != 0;
+            q.pending = false;
+        }
+    }
+
+    // Kutija je malo veca od modela, da njegova dubina ne bi zaklonila sopstveni upit
+    WorldBox(m, M, q.boxCenter, q.boxExtent);
+    q.boxExtent += glm::vec3(0.01f);
+    q.room = room;
+    q.requested = true;
+
+    // Kamera u kutiji (ili tik uz nju): near ravan odseca lica, pa upit ne vazi
+    glm::vec3 d = glm::abs(lodEye - q.boxCenter) - q.boxExtent;
+    if (d.x < 0.1f && d.y < 0.1f && d.z < 0.1f)
+        q.visible = true;
+
+    q.frames++;
+    bool drawIt = q.visible || !occlusionOn;
+    if (!drawIt) q.skipped++;
+    return drawIt;
+}
 
-    glEnable(GL_DEPTH_TEST);
+void Renderer::IssueOcclusionQueries()
+{
+    bool begun = false;
+    for (OcclusionQuery& q : occlusion)
+    {
+        if (!q.requested) continue;
+        q.requested = false;
+        // Prosli upit jos nije gotov; novi bi samo produzio cekanje
+        if (q.pending) continue;
+
+        // Van kadra se ne pita; kad se vrati, model se crta bar do prvog rezultata
+        bool roomHidden = q.room >= 0 && (size_t)q.room < visibleRooms.size() && !visibleRooms[q.room];
+        if (roomHidden || !BoxInFrustum(frustum, q.boxCenter, q.boxExtent))
+        {
+            q.visible = true;
+            continue;
+        }
+
+        if (!begun)
+        {
+            // Samo test dubine; bez odstranjivanja, jer i zadnja lica mogu biti jedina vidljiva
+            DrawState s;
+            s.cull = false;
+            s.depthWrite = false;
+            ApplyState(s);
+            gGLState.ColorMask(false);
+            ApplyMeshFormat(cube);
+            begun = true;
+        }
+
+        glm::mat4 Mb = glm::scale(glm::translate(glm::mat4(1.0f), q.boxCenter), q.boxExtent / 0.1f);
+        SetDraw(Mb, glm::vec4(1.0f), 0);
+        if (!CommitDraw())
+        {
+            q.visible = true;
+            continue;
+        }
+        gGLState.BindVertexArray(cube.vao);
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, q.query);
+        glDrawElements(GL_TRIANGLES, cube.indexCount, cube.indexType, (void*)0);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+        q.pending = true;
+        q.issued++;
+    }
+
+    // glClear sledeceg frejma postuje masku boje
+    if (begun) gGLState.ColorMask(true);
 }
 
-void Renderer::DrawTexturedMesh(const MeshGL& m, const glm::mat4& M, GLuint texID, const glm::vec4& tint)
+void Renderer::IssueCube(const glm::mat4& M, const glm::vec4& tint, bool transparentFlag)
 {
-    glUseProgram(shader);
+    SetDraw(M, tint, 0);
 
-    glUniform1i(uUseTex, 1);
-    glUniform1i(uTransparent, 1);
-    glUniform4f(uTint, tint.r, tint.g, tint.b, tint.a);
-    glUniformMatrix4fv(uM, 1, GL_FALSE, glm::value_ptr(M));
+    ApplyMeshFormat(cube);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(cube.vao);
+    glDrawElements(GL_TRIANGLES, cube.indexCount, cube.indexType, (void*)0);
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texID);
+void Renderer::IssuePlaceholder(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint)
+{
+    glm::vec3 center = (m.boundsMin + m.boundsMax) * 0.5f;
+    glm::vec3 size = glm::max(m.boundsMax - m.boundsMin, glm::vec3(1e-4f));
 
-    glBindVertexArray(m.vao);
-    glDrawArrays(GL_TRIANGLES, 0, m.vertexCount);
-    glBindVertexArray(0);
+    glm::mat4 Mb = glm::translate(M, center);
+    Mb = glm::scale(Mb, size / 0.2f);
 
-    glUniform1i(uUseTex, 0);
+    IssueCube(Mb, tint, false);
 }
 
-void Renderer::DrawCenter()
+void Renderer::IssueMeshTriangles(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint, bool transparentFlag)
 {
-    glUseProgram(shader);
+    if (m.isPlaceholder) { IssuePlaceholder(m, M, tint); return; }
+
+    SetDraw(M, tint, 0);
 
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
+    ApplyMeshFormat(m);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(m.vao);
+    DrawTriangles(m, SelectLod(m, M));
+}
 
-    glm::mat4 I(1.0f);
-    glUniformMatrix4fv(uV, 1, GL_FALSE, glm::value_ptr(I));
-    glUniformMatrix4fv(uP, 1, GL_FALSE, glm::value_ptr(I));
-    glUniformMatrix4fv(uM, 1, GL_FALSE, glm::value_ptr(I));
+void Renderer::IssueOverlay()
+{
+    // Dubina i odstranjivanje su iskljuceni kroz stanje paketa
+    gGLState.Enable(GL_BLEND, true);
+    gGLState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    glUniform1i(uUseTex, 1);
-    glUniform1i(uTransparent, 1);
-    glUniform4f(uTint, 1, 1, 1, 1);
+    SetDraw(glm::mat4(1.0f), glm::vec4(1.0f, 1.0f, 1.0f, 0.4f), 1, DRAW_MODE_SCREEN);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, centerTex);
+    gGLState.BindTexture(0, GL_TEXTURE_2D, gTextures.Get(overlayTex));
+    gTextures.NoteUse(overlayTex, 1e6f);
+    gSamplers.Bind(0, SamplerPreset::TrilinearClamp);
 
-    glBindVertexArray(centerQuad.vao);
+    ApplyMeshFormat(overlayQuad);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(overlayQuad.vao);
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-    glBindVertexArray(0);
+}
 
-    glEnable(GL_DEPTH_TEST);
+void Renderer::IssueTexturedMesh(const MeshGL& m, const glm::mat4& M, GLuint texID, const glm::vec4& tint)
+{
+    if (m.isPlaceholder) { IssuePlaceholder(m, M, tint); return; }
+
+    SetDraw(M, tint, 1);
+
+    gGLState.BindTexture(0, GL_TEXTURE_2D, texID);
+    gSamplers.Bind(0, SamplerPreset::AnisoClamp);
+    gTextures.NoteUse(texID, ProjectedPixels(m, M));
+
+    ApplyMeshFormat(m);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(m.vao);
+    DrawTriangles(m, SelectLod(m, M));
+}
+
+void Renderer::IssueSubMeshes(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint)
+{
+    if (m.isPlaceholder) { IssuePlaceholder(m, M, tint); return; }
+
+    SetDraw(M, tint, 0);
+
+    size_t indexSize = (m.indexType == GL_UNSIGNED_SHORT) ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    float pixels = ProjectedPixels(m, M);
+
+    ApplyMeshFormat(m);
+    gGLState.BindVertexArray(m.vao);
+    for (const SubMesh& p : m.parts)
+    {
+        bool textured = p.tex.Valid();
+        draw.flags.x = textured ? 1 : 0;
+        if (textured)
+        {
+            gGLState.BindTexture(0, GL_TEXTURE_2D, gTextures.Get(p.tex));
+            gSamplers.Bind(0, p.clampUV ? SamplerPreset::AnisoClamp : SamplerPreset::AnisoRepeat);
+            gTextures.NoteUse(p.tex, pixels);
+        }
+
+        if (!CommitDraw()) continue;
+        glDrawElements(GL_TRIANGLES, p.count, m.indexType, (void*)(p.first * indexSize));
+    }
+}
+
+void Renderer::IssueCenter()
+{
+    // Dubina i odstranjivanje su iskljuceni kroz stanje paketa
+    gGLState.Enable(GL_BLEND, true);
+    gGLState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    SetDraw(glm::mat4(1.0f), glm::vec4(1.0f), 1, DRAW_MODE_SCREEN);
+
+    gGLState.BindTexture(0, GL_TEXTURE_2D, gTextures.Get(centerTex));
+    gTextures.NoteUse(centerTex, 1e6f);
+    gSamplers.Bind(0, SamplerPreset::TrilinearClamp);
+
+    ApplyMeshFormat(centerQuad);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(centerQuad.vao);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 }
 
 void Renderer::CreateScreenQuad()
@@ -320,74 +723,286 @@ void Renderer::CreateScreenQuad()
     CreateFromFloats(screenQuad, q, false);
 }
 
-void Renderer::DrawTexturedScreen(const glm::mat4& M, GLuint texID, const glm::vec4& tint)
+void Renderer::IssueTexturedScreen(const glm::mat4& M, GLuint texID, const glm::vec4& tint)
 {
-    glUseProgram(shader);
-
-    glUniform1i(uUseTex, 1);
-    glUniform1i(uTransparent, 1);
-    glUniform4f(uTint, tint.r, tint.g, tint.b, tint.a);
-    glUniformMatrix4fv(uM, 1, GL_FALSE, glm::value_ptr(M));
+    SetDraw(M, tint, 1);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texID);
-    glUniform1i(uTex, 0);
+    gGLState.BindTexture(0, GL_TEXTURE_2D, texID);
+    gSamplers.Bind(0, SamplerPreset::TrilinearClamp);
+    gTextures.NoteUse(texID, ProjectedPixels(screenQuad, M));
 
-    glBindVertexArray(screenQuad.vao);
+    ApplyMeshFormat(screenQuad);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(screenQuad.vao);
     glDrawArrays(GL_TRIANGLES, 0, screenQuad.vertexCount);
-    glBindVertexArray(0);
-
-    glUniform1i(uUseTex, 0);
 }
 
-void Renderer::DrawTexturedCube(const glm::mat4& M, GLuint tex, const glm::vec4& tint)
+void Renderer::IssueGlyphs(GlyphArray& glyphs, const glm::mat4& M)
 {
-    glUseProgram(shader);
-
-    glUniform1i(uUseTex, 1);
-    glUniform1i(uTransparent, 0);
-    glUniform4f(uTint, tint.r, tint.g, tint.b, tint.a);
-    glUniformMatrix4fv(uM, 1, GL_FALSE, glm::value_ptr(M));
+    // Bela 1x1 iz registra nije niz, pa se do uploada ne crta nista
+    if (gTextures.GetState(glyphs.texture) != TextureRegistry::State::Loaded) return;
+    GLsizei n = glyphs.Upload(stream);
+    if (n == 0) return;
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glUniform1i(uTex, 0);
+    SetDraw(M, glm::vec4(1.0f), 2, DRAW_MODE_GLYPHS);
 
-    glBindVertexArray(cube.vao);
-    for (int i = 0; i < 6; ++i)
-        glDrawArrays(GL_TRIANGLE_FAN, i * 4, 4);
-    glBindVertexArray(0);
+    gGLState.BindTexture(1, GL_TEXTURE_2D_ARRAY, gTextures.Get(glyphs.texture));
+    gSamplers.Bind(1, SamplerPreset::TrilinearClamp);
 
-    glUniform1i(uUseTex, 0);
+    ApplyMeshFormat(screenQuad);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(glyphs.vao);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, n);
 }
 
-void Renderer::DrawTexturedCubeFace(const glm::mat4& M, GLuint tex, const glm::vec4& baseTint, const glm::vec4& faceTint, CubeFace face, float lift)
+void Renderer::IssueTexturedCube(const glm::mat4& M, GLuint tex, const glm::vec4& tint)
 {
-    DrawCube(M, baseTint, false);
+    SetDraw(M, tint, 1);
 
-    glUseProgram(shader);
+    gGLState.BindTexture(0, GL_TEXTURE_2D, tex);
+    gSamplers.Bind(0, SamplerPreset::AnisoClamp);
+    gTextures.NoteUse(tex, ProjectedPixels(cube, M));
 
-    glUniform1i(uUseTex, 1);
-    glUniform1i(uTransparent, 0);
-    glUniform4f(uTint, faceTint.r, faceTint.g, faceTint.b, faceTint.a);
+    ApplyMeshFormat(cube);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(cube.vao);
+    glDrawElements(GL_TRIANGLES, cube.indexCount, cube.indexType, (void*)0);
+}
+
+void Renderer::IssueTexturedCubeFace(const glm::mat4& M, GLuint tex, const glm::vec4& baseTint, const glm::vec4& faceTint, CubeFace face, float lift)
+{
+    IssueCube(M, baseTint, false);
 
     glm::mat4 M2 = glm::scale(M, glm::vec3(1.0f + lift, 1.0f + lift, 1.0f + lift));
-    glUniformMatrix4fv(uM, 1, GL_FALSE, glm::value_ptr(M2));
+    SetDraw(M2, faceTint, 1);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glUniform1i(uTex, 0);
+    gGLState.BindTexture(0, GL_TEXTURE_2D, tex);
+    gSamplers.Bind(0, SamplerPreset::AnisoClamp);
+    gTextures.NoteUse(tex, ProjectedPixels(cube, M2));
 
-    glBindVertexArray(cube.vao);
+    ApplyMeshFormat(cube);
+    if (!CommitDraw()) return;
+    gGLState.BindVertexArray(cube.vao);
 
     int f = (int)face;          
     glDrawArrays(GL_TRIANGLE_FAN, f * 4, 4);
+}
 
-    glBindVertexArray(0);
+// Zajednicka polja paketa; dubina je rastojanje centra granicne sfere (ili pocetka M) od kamere
+DrawPacket Renderer::Record(DrawKind kind, const MeshGL* mesh, const glm::mat4& M, GLuint tex, bool blended) const
+{
+    DrawPacket p;
+    p.kind = kind;
+    p.state = state;
+    p.mesh = mesh;
+    p.M = M;
+    p.tex = tex;
+    p.room = room;
+
+    glm::vec3 center = glm::vec3(M[3]);
+    if (mesh)
+    {
+        float radius;
+        WorldSphere(*mesh, M, center, radius);
+        // HUD je vec u clip prostoru
+        if (pass != RenderPass::Hud)
+        {
+            WorldBox(*mesh, M, p.boundsCenter, p.boundsExtent);
+            p.boundsRadius = radius;
+        }
+    }
+    float depth = glm::length(center - lodEye);
+    p.key = MakeSortKey(pass, blended, shader, tex, mesh ? mesh->vao : 0, depth);
+    return p;
+}
 
-    glUniform1i(uUseTex, 0);
+void Renderer::DrawCube(const glm::mat4& M, const glm::vec4& tint, bool transparentFlag)
+{
+    DrawPacket p = Record(DrawKind::Cube, &cube, M, 0, transparentFlag || tint.a < 1.0f);
+    p.tint = tint;
+    p.transparent = transparentFlag;
+    queue.Push(p);
 }
 
+void Renderer::DrawMeshTriangles(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint, bool transparentFlag)
+{
+    DrawPacket p = Record(DrawKind::Mesh, &m, M, 0, transparentFlag || tint.a < 1.0f);
+    p.tint = tint;
+    p.transparent = transparentFlag;
+    queue.Push(p);
+}
 
+void Renderer::DrawOverlay()
+{
+    DrawPacket p;
+    p.kind = DrawKind::Overlay;
+    p.state.depthTest = false;
+    p.state.cull = false;
+    p.key = MakeSortKey(RenderPass::Hud, true, shader, gTextures.Get(overlayTex), overlayQuad.vao, 0.0f);
+    queue.Push(p);
+}
+
+void Renderer::DrawTexturedMesh(const MeshGL& m, const glm::mat4& M, GLuint texID, const glm::vec4& tint)
+{
+    DrawPacket p = Record(DrawKind::TexturedMesh, &m, M, texID, tint.a < 1.0f);
+    p.tint = tint;
+    queue.Push(p);
+}
+
+void Renderer::DrawSubMeshes(const MeshGL& m, const glm::mat4& M, const glm::vec4& tint)
+{
+    DrawPacket p = Record(DrawKind::SubMeshes, &m, M, 0, tint.a < 1.0f);
+    p.tint = tint;
+    queue.Push(p);
+}
+
+void Renderer::DrawCenter()
+{
+    DrawPacket p;
+    p.kind = DrawKind::Center;
+    p.state.depthTest = false;
+    p.state.cull = false;
+    p.key = MakeSortKey(RenderPass::Hud, true, shader, gTextures.Get(centerTex), centerQuad.vao, 0.0f);
+    queue.Push(p);
+}
+
+void Renderer::DrawTexturedScreen(const glm::mat4& M, GLuint texID, const glm::vec4& tint)
+{
+    DrawPacket p = Record(DrawKind::Screen, &screenQuad, M, texID, tint.a < 1.0f);
+    p.tint = tint;
+    queue.Push(p);
+}
+
+void Renderer::DrawGlyphs(GlyphArray& glyphs, const glm::mat4& M)
+{
+    // Znakovi imaju providne ivice i leze tik ispred panela, pa idu posle neprovidnog
+    DrawPacket p = Record(DrawKind::Glyphs, nullptr, M, gTextures.Get(glyphs.texture), true);
+    p.glyphs = &glyphs;
+    queue.Push(p);
+}
+
+void Renderer::DrawTexturedCube(const glm::mat4& M, GLuint tex, const glm::vec4& tint)
+{
+    DrawPacket p = Record(DrawKind::TexturedCube, &cube, M, tex, tint.a < 1.0f);
+    p.tint = tint;
+    queue.Push(p);
+}
+
+void Renderer::DrawTexturedCubeFace(const glm::mat4& M, GLuint tex, const glm::vec4& baseTint, const glm::vec4& faceTint, CubeFace face, float lift)
+{
+    DrawPacket p = Record(DrawKind::TexturedCubeFace, &cube, M, tex, baseTint.a < 1.0f || faceTint.a < 1.0f);
+    p.tint = baseTint;
+    p.faceTint = faceTint;
+    p.face = (int)face;
+    p.lift = lift;
+    queue.Push(p);
+}
+
+void Renderer::ClearDepth()
+{
+    // Najmanji kljuc u prolazu - izvrsava se pre svega ostalog u njemu
+    DrawPacket p;
+    p.kind = DrawKind::ClearDepth;
+    p.key = (uint64_t)pass << 62;
+    queue.Push(p);
+}
+
+void Renderer::ApplyState(const DrawState& s)
+{
+    // Senka preskace sve sto se nije promenilo od proslog paketa
+    gGLState.Enable(GL_CULL_FACE, s.cull);
+    gGLState.Enable(GL_DEPTH_TEST, s.depthTest);
+    gGLState.DepthMask(s.depthWrite);
+    gGLState.Enable(GL_POLYGON_OFFSET_FILL, s.polygonOffset);
+    if (s.polygonOffset)
+        gGLState.PolygonOffset(-1.0f, -1.0f);
+
+    // Deo Draw bloka; ide sa sledecim CommitDraw
+    draw.flags.y = s.unlit ? 1 : 0;
+    draw.params.x = s.emissive;
+}
+
+void Renderer::Execute(const DrawPacket& p)
+{
+    switch (p.kind)
+    {
+    case DrawKind::Cube:             IssueCube(p.M, p.tint, p.transparent); break;
+    case DrawKind::Mesh:             IssueMeshTriangles(*p.mesh, p.M, p.tint, p.transparent); break;
+    case DrawKind::TexturedMesh:     IssueTexturedMesh(*p.mesh, p.M, p.tex, p.tint); break;
+    case DrawKind::SubMeshes:        IssueSubMeshes(*p.mesh, p.M, p.tint); break;
+    case DrawKind::TexturedCube:     IssueTexturedCube(p.M, p.tex, p.tint); break;
+    case DrawKind::TexturedCubeFace: IssueTexturedCubeFace(p.M, p.tex, p.tint, p.faceTint, (CubeFace)p.face, p.lift); break;
+    case DrawKind::Screen:           IssueTexturedScreen(p.M, p.tex, p.tint); break;
+    case DrawKind::Glyphs:           IssueGlyphs(*p.glyphs, p.M); break;
+    case DrawKind::Overlay:          IssueOverlay(); break;
+    case DrawKind::Center:           IssueCenter(); break;
+    case DrawKind::ClearDepth:       glClear(GL_DEPTH_BUFFER_BIT); break;
+    }
+}
+
+void Renderer::Submit()
+{
+    // Ucitavanje izmedju frejmova vezuje teksture i bafere mimo senke
+    gGLState.BeginFrame();
+    stream.BeginFrame();
+    // Svaki nacrtan frejm je novi frejm koriscenja, i kad strimovanje ceka radne niti
+    gTextures.BeginFrame();
+    // Van kadra i iz soba koje se ne vide kroz portale ne ide ni u sortiranje ni u stream bafer
+    queue.Cull(frustum, visibleRooms);
+    queue.Sort();
+
+    // Kamera i svetla: jedan upis po frejmu
+    StreamAlloc f = stream.Alloc(sizeof(FrameUniforms), uniformAlign);
+    if (f.Valid())
+    {
+        std::memcpy(f.ptr, &frame, sizeof(FrameUniforms));
+        stream.Commit(f);
+        gGLState.BindUniformRange(FRAME_BINDING, stream.Buffer(), f.offset, sizeof(FrameUniforms));
+    }
+    // Prvi poziv frejma uvek salje svoj blok
+    lastDrawValid = false;
+    drawUploads = 0;
+    drawReuses = 0;
+
+    gGLState.UseProgram(shader);
+    bool queriesIssued = false;
+    for (size_t i = 0; i < queue.Size(); i++)
+    {
+        const DrawPacket& p = queue[i];
+        // Upiti zaklonjenosti posle neprovidnog dela scene, kad su svi zaklanjaci u dubini
+        if (!queriesIssued && (p.key >> 61) != 0)
+        {
+            IssueOcclusionQueries();
+            queriesIssued = true;
+        }
+        ApplyState(p.state);
+        Execute(p);
+    }
+    if (!queriesIssued)
+        IssueOcclusionQueries();
+
+    // glClear na pocetku sledeceg frejma trazi upis dubine; VAO se odvezuje jednom,
+    // da pravljenje mesha van frejma ne bi menjalo poslednji
+    ApplyState(DrawState());
+    gGLState.BindVertexArray(0);
+    stream.EndFrame();
+    queue.Clear();
+    state = DrawState();
+    pass = RenderPass::World;
+    room = -1;
+}
+
+
+void Renderer::PrintStats() const
+{
+    queue.PrintStats();
+    gGLState.PrintStats();
+    std::cout << "[UBO] Draw blokova " << drawUploads << ", ponovljenih " << drawReuses << "\n";
+    stream.PrintStats();
+    for (const OcclusionQuery& q : occlusion)
+        std::cout << "[OCCLUSION] " << q.name << ": " << (q.visible ? "vidljiv" : "zaklonjen")
+                  << ", preskocen " << q.skipped << " od " << q.frames << " frejmova, upita " << q.issued
+                  << (occlusionOn ? "" : " (iskljuceno)") << "\n";
+}
 
 bool gPrevLookLed = false;
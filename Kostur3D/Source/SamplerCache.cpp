@@ -0,0 +1,55 @@
+#include "Header/SamplerCache.h"
+#include <algorithm>
+#include <iostream>
+
+SamplerCache gSamplers;
+
+void SamplerCache::Init(float maxAnisotropy)
+{
+    Destroy();
+
+    anisotropy = 1.0f;
+    if (GLEW_EXT_texture_filter_anisotropic)
+    {
+        GLfloat hw = 1.0f;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &hw);
+        anisotropy = std::max(1.0f, std::min(maxAnisotropy, hw));
+    }
+
+    glGenSamplers((GLsizei)SamplerPreset::Count, samplers);
+    for (int i = 0; i < (int)SamplerPreset::Count; i++)
+    {
+        SamplerPreset p = (SamplerPreset)i;
+        bool repeat = p == SamplerPreset::TrilinearRepeat || p == SamplerPreset::AnisoRepeat;
+        bool aniso = p == SamplerPreset::AnisoClamp || p == SamplerPreset::AnisoRepeat;
+        GLint wrap = repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+
+        glSamplerParameteri(samplers[i], GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glSamplerParameteri(samplers[i], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glSamplerParameteri(samplers[i], GL_TEXTURE_WRAP_S, wrap);
+        glSamplerParameteri(samplers[i], GL_TEXTURE_WRAP_T, wrap);
+        if (aniso && anisotropy > 1.0f)
+            glSamplerParameterf(samplers[i], GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+    }
+
+    std::cout << "[SAMPLER] anizotropija " << anisotropy << "x\n";
+}
+
+void SamplerCache::Destroy()
+{
+    if (samplers[0])
+        glDeleteSamplers((GLsizei)SamplerPreset::Count, samplers);
+    for (GLuint& s : samplers) s = 0;
+    for (GLuint& b : bound) b = 0;
+}
+
+void SamplerCache::Bind(GLuint unit, SamplerPreset p)
+{
+    GLuint s = samplers[(int)p];
+    if (unit < (GLuint)MAX_UNITS)
+    {
+        if (bound[unit] == s) return;
+        bound[unit] = s;
+    }
+    glBindSampler(unit, s);
+}
@@ -0,0 +1,158 @@
+#include "Header/StaticBatch.h"
+#include "Header/MeshBuilders.h"
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Raspored kao u Renderer::CreateFromFloats: pozicija, boja, UV, normala
+static constexpr size_t VERTEX_FLOATS = 12;
+// Ivica celije u metrima; soba je oko 4 x 4 m, pa je to nekoliko celija
+static constexpr float CELL_SIZE = 1.5f;
+
+glm::ivec2 StaticBatch::CellOf(const glm::mat4& M)
+{
+    return glm::ivec2((int)std::floor(M[3].x / CELL_SIZE), (int)std::floor(M[3].z / CELL_SIZE));
+}
+
+StaticBatch::Group& StaticBatch::GetGroup(bool cull, const glm::ivec2& cell, TextureHandle tex)
+{
+    for (Group& g : groups)
+        if (g.cull == cull && g.room == room && g.cell == cell && g.tex.index == tex.index && g.tex.generation == tex.generation)
+            return g;
+
+    groups.emplace_back();
+    Group& g = groups.back();
+    g.cull = cull;
+    g.room = room;
+    g.cell = cell;
+    g.tex = tex;
+    // Grupa drzi svoju referencu; predaje je delu mesha u Build
+    if (tex.Valid()) gTextures.AddRef(tex);
+    return g;
+}
+
+void StaticBatch::AddFaces(Group& g, const glm::mat4& M, const glm::vec4& tint, int firstFace, int faceCount)
+{
+    if (cubeVerts.empty()) BuildCube(cubeVerts);
+
+    glm::mat3 N = glm::transpose(glm::inverse(glm::mat3(M)));
+    for (int f = firstFace; f < firstFace + faceCount; f++)
+    {
+        uint32_t base = (uint32_t)(g.vertices.size() / VERTEX_FLOATS);
+        for (int v = 0; v < 4; v++)
+        {
+            const float* src = &cubeVerts[(size_t)(f * 4 + v) * VERTEX_FLOATS];
+            glm::vec3 p = glm::vec3(M * glm::vec4(src[0], src[1], src[2], 1.0f));
+            glm::vec4 c = glm::vec4(src[3], src[4], src[5], src[6]) * tint;
+            glm::vec3 n = glm::normalize(N * glm::vec3(src[9], src[10], src[11]));
+
+            const float out[VERTEX_FLOATS] = { p.x, p.y, p.z, c.r, c.g, c.b, c.a, src[7], src[8], n.x, n.y, n.z };
+            g.vertices.insert(g.vertices.end(), out, out + VERTEX_FLOATS);
+        }
+        const uint32_t fan[6] = { 0, 1, 2, 0, 2, 3 };
+        for (uint32_t i : fan)
+            g.indices.push_back(base + i);
+    }
+}
+
+void StaticBatch::AddCube(const glm::mat4& M, const glm::vec4& tint, bool cull)
+{
+    AddFaces(GetGroup(cull, CellOf(M), TextureHandle()), M, tint, 0, 6);
+    sourceDraws++;
+}
+
+void StaticBatch::AddTexturedCube(const glm::mat4& M, TextureHandle tex, const glm::vec4& tint, bool cull)
+{
+    AddFaces(GetGroup(cull, CellOf(M), tex), M, tint, 0, 6);
+    sourceDraws++;
+}
+
+void StaticBatch::AddTexturedCubeFace(const glm::mat4& M, TextureHandle tex, const glm::vec4& baseTint, const glm::vec4& faceTint,
+                                      CubeFace face, float lift, bool cull)
+{
+    glm::ivec2 cell = CellOf(M);
+    AddFaces(GetGroup(cull, cell, TextureHandle()), M, baseTint, 0, 6);
+
+    glm::mat4 M2 = glm::scale(M, glm::vec3(1.0f + lift));
+    AddFaces(GetGroup(cull, cell, tex), M2, faceTint, (int)face, 1);
+    sourceDraws += 2;
+}
+
+void StaticBatch::Build(Renderer& R)
+{
+    // Redosled celija prati prvo pojavljivanje u grupama
+    std::vector<const Group*> keys;
+    for (const Group& g : groups)
+    {
+        if (g.indices.empty()) continue;
+        bool found = false;
+        for (const Group* k : keys)
+            found = found || (k->cull == g.cull && k->room == g.room && k->cell == g.cell);
+        if (!found) keys.push_back(&g);
+    }
+
+    // Adrese meshova idu u red za crtanje, pa se vektor ne sme realocirati posle pravljenja
+    cells.resize(keys.size());
+    size_t calls = 0;
+    for (size_t c = 0; c < keys.size(); c++)
+    {
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<SubMesh> parts;
+
+        for (Group& g : groups)
+        {
+            const Group& k = *keys[c];
+            if (g.cull != k.cull || g.room != k.room || g.cell != k.cell || g.indices.empty()) continue;
+
+            uint32_t base = (uint32_t)(vertices.size() / VERTEX_FLOATS);
+            SubMesh part;
+            part.first = (GLsizei)indices.size();
+            part.count = (GLsizei)g.indices.size();
+            part.tex = g.tex;
+            part.clampUV = true;
+            for (uint32_t i : g.indices)
+                indices.push_back(base + i);
+            vertices.insert(vertices.end(), g.vertices.begin(), g.vertices.end());
+            parts.push_back(part);
+        }
+
+        Cell& cell = cells[c];
+        cell.cull = keys[c]->cull;
+        cell.room = keys[c]->room;
+        R.CreateIndexed(cell.mesh, vertices.data(), vertices.size(), indices.data(), indices.size());
+        cell.mesh.parts = std::move(parts);
+        calls += cell.mesh.parts.size();
+    }
+
+    std::cout << "[STATIC] " << sourceDraws << " poziva spojeno u " << calls << " grupa, "
+              << cells.size() << " celija\n";
+    groups.clear();
+    cubeVerts.clear();
+}
+
+void StaticBatch::Draw(Renderer& R, bool cullOn)
+{
+    bool saved = R.state.cull;
+    int savedRoom = R.room;
+    for (const Cell& cell : cells)
+    {
+        R.state.cull = cullOn && cell.cull;
+        R.room = cell.room;
+        // Verteksi su vec u svetu; granice mesha su granice celije
+        R.DrawSubMeshes(cell.mesh, glm::mat4(1.0f));
+    }
+    R.state.cull = saved;
+    R.room = savedRoom;
+}
+
+void StaticBatch::Destroy(Renderer& R)
+{
+    // DestroyMesh pusta i teksture delova
+    for (Cell& cell : cells)
+        R.DestroyMesh(cell.mesh);
+    cells.clear();
+    for (Group& g : groups)
+        gTextures.Release(g.tex);
+    groups.clear();
+}
@@ -0,0 +1,158 @@
+#include "Header/StreamBuffer.h"
+#include <algorithm>
+#include <iostream>
+
+bool StreamBuffer::Init(size_t bytesPerFrame, int frameCount)
+{
+    Destroy();
+
+    frameBytes = bytesPerFrame;
+    persistent = GLEW_ARB_buffer_storage != 0;
+
+    // GL_COPY_WRITE_BUFFER ne menja vezivanja koja prati gGLState
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (persistent)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr total = (GLsizeiptr)(frameBytes * (size_t)frameCount);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, total, nullptr, flags);
+        mapped = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total, flags);
+        if (!mapped)
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            Destroy();
+            return false;
+        }
+        fences.assign((size_t)frameCount, nullptr);
+    }
+    else
+    {
+        // Jedan segment; orphan svakog frejma daje drajveru da sam rotira memoriju
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)frameBytes, nullptr, GL_STREAM_DRAW);
+        shadow.resize(frameBytes);
+        fences.assign(1, nullptr);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    segment = 0;
+    head = 0;
+    std::cout << "[STREAM] " << (persistent ? "trajno mapiran" : "orphan") << ", "
+              << (frameBytes >> 10) << " KB po frejmu\n";
+    return true;
+}
+
+void StreamBuffer::Destroy()
+{
+    for (GLsync& f : fences)
+        if (f) glDeleteSync(f);
+    fences.clear();
+
+    if (buffer)
+    {
+        if (mapped)
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &buffer);
+    }
+    buffer = 0;
+    mapped = nullptr;
+    shadow.clear();
+    frameBytes = 0;
+    head = 0;
+}
+
+void StreamBuffer::WaitFence(GLsync& fence)
+{
+    if (!fence) return;
+
+    if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+        // GPU kasni vise od dva frejma - ovo je jedino mesto gde se ceka
+        stalls++;
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::BeginFrame()
+{
+    if (!buffer) return;
+
+    lastBytes = head;
+    peakBytes = std::max(peakBytes, head);
+    head = 0;
+
+    if (grow)
+    {
+        // Stari bafer drajver brise tek kad ga GPU zavrsi
+        grow = false;
+        int frameCount = persistent ? (int)fences.size() : 3;
+        size_t bytes = frameBytes;
+        if (!Init(bytes * 2, frameCount)) Init(bytes, frameCount);
+        return;
+    }
+
+    if (persistent)
+    {
+        segment = (segment + 1) % (int)fences.size();
+        WaitFence(fences[segment]);
+    }
+    else
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)frameBytes, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+}
+
+void StreamBuffer::EndFrame()
+{
+    if (!buffer || !persistent) return;
+    if (fences[segment]) glDeleteSync(fences[segment]);
+    fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamAlloc StreamBuffer::Alloc(size_t bytes, size_t align)
+{
+    StreamAlloc a;
+    if (!buffer || bytes > frameBytes) return a;
+
+    size_t start = (head + align - 1) & ~(align - 1);
+    if (start + bytes > frameBytes)
+    {
+        // Ranije dodeljeno u ovom frejmu (npr. instance) GPU jos nije procitao, pa nema
+        // vracanja na pocetak; poziv se preskace, a sledeci frejm dobija dvostruko veci bafer
+        overflows++;
+        grow = true;
+        return a;
+    }
+    head = start + bytes;
+
+    size_t base = persistent ? (size_t)segment * frameBytes : 0;
+    a.ptr = persistent ? mapped + base + start : shadow.data() + start;
+    a.offset = (GLintptr)(base + start);
+    a.size = (GLsizeiptr)bytes;
+    return a;
+}
+
+void StreamBuffer::Commit(const StreamAlloc& a)
+{
+    // Koherentno mapiranje: upis je vec vidljiv GPU-u
+    if (persistent || !a.Valid()) return;
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, a.offset, a.size, a.ptr);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void StreamBuffer::PrintStats() const
+{
+    std::cout << "[STREAM] frejm " << (lastBytes >> 10) << " KB (najvise " << (peakBytes >> 10)
+              << " od " << (frameBytes >> 10) << " KB), cekanja na GPU " << stalls
+              << ", prelivanja " << overflows << "\n";
+}
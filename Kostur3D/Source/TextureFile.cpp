@@ -0,0 +1,303 @@
+#include "Header/TextureFile.h"
+#include "Header/AssetArchive.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+static constexpr unsigned char KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+static constexpr uint32_t KTX_ENDIAN = 0x04030201;
+static constexpr char KEY_SOURCE[] = "KosturSource";
+static constexpr char KEY_ORIENTATION[] = "KTXorientation";
+
+struct KtxHeader {
+    unsigned char identifier[12];
+    uint32_t endianness;
+    uint32_t glType;
+    uint32_t glTypeSize;
+    uint32_t glFormat;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+
+static_assert(sizeof(KtxHeader) == 64, "ktx header layout");
+
+struct SourceStamp {
+    uint64_t size;
+    uint64_t hash;
+};
+
+static size_t Align4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+size_t TextureFile::Bytes() const
+{
+    size_t total = 0;
+    for (const TextureLevel& l : levels) total += l.size;
+    return total;
+}
+
+std::string TextureFilePath(const char* srcPath)
+{
+    return std::string(srcPath) + ".ktx";
+}
+
+size_t TextureLevelSize(uint32_t format, int width, int height)
+{
+    size_t bw = (size_t)(width + 3) / 4;
+    size_t bh = (size_t)(height + 3) / 4;
+    if (format == TEXFMT_BC1) return bw * bh * 8;
+    if (format == TEXFMT_BC3) return bw * bh * 16;
+    return (size_t)width * (size_t)height * 4;
+}
+
+// 565 -> RGB8, kao sto ga siri GPU
+static void Unpack565(uint16_t c, unsigned char* out)
+{
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (unsigned char)((r << 3) | (r >> 2));
+    out[1] = (unsigned char)((g << 2) | (g >> 4));
+    out[2] = (unsigned char)((b << 3) | (b >> 2));
+}
+
+// Boje bloka 4x4; u BC3 je uvek rezim sa 4 boje
+static void DecodeColorBlock(const unsigned char* b, bool fourColor, unsigned char (&px)[16][4])
+{
+    uint16_t c0 = (uint16_t)(b[0] | (b[1] << 8));
+    uint16_t c1 = (uint16_t)(b[2] | (b[3] << 8));
+    unsigned char pal[4][4] = {};
+    Unpack565(c0, pal[0]);
+    Unpack565(c1, pal[1]);
+    pal[0][3] = pal[1][3] = pal[2][3] = pal[3][3] = 255;
+    for (int k = 0; k < 3; k++)
+    {
+        if (fourColor || c0 > c1)
+        {
+            pal[2][k] = (unsigned char)((2 * pal[0][k] + pal[1][k]) / 3);
+            pal[3][k] = (unsigned char)((pal[0][k] + 2 * pal[1][k]) / 3);
+        }
+        else
+        {
+            pal[2][k] = (unsigned char)((pal[0][k] + pal[1][k]) / 2);
+            pal[3][k] = 0;
+        }
+    }
+    if (!fourColor && c0 <= c1) pal[3][3] = 0;
+
+    uint32_t bits = (uint32_t)b[4] | ((uint32_t)b[5] << 8) | ((uint32_t)b[6] << 16) | ((uint32_t)b[7] << 24);
+    for (int i = 0; i < 16; i++)
+        std::memcpy(px[i], pal[(bits >> (2 * i)) & 3], 4);
+}
+
+static void DecodeAlphaBlock(const unsigned char* b, unsigned char (&px)[16][4])
+{
+    unsigned char a[8];
+    a[0] = b[0];
+    a[1] = b[1];
+    if (a[0] > a[1])
+        for (int i = 1; i < 7; i++) a[i + 1] = (unsigned char)(((7 - i) * a[0] + i * a[1]) / 7);
+    else
+    {
+        for (int i = 1; i < 5; i++) a[i + 1] = (unsigned char)(((5 - i) * a[0] + i * a[1]) / 5);
+        a[6] = 0;
+        a[7] = 255;
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= (uint64_t)b[2 + i] << (8 * i);
+    for (int i = 0; i < 16; i++)
+        px[i][3] = a[(bits >> (3 * i)) & 7];
+}
+
+bool DecodeTextureLevel(uint32_t format, const TextureLevel& level, std::vector<unsigned char>& rgba)
+{
+    if (level.size != TextureLevelSize(format, level.width, level.height)) return false;
+
+    rgba.resize((size_t)level.width * level.height * 4);
+    if (format == TEXFMT_RGBA8)
+    {
+        std::memcpy(rgba.data(), level.data, rgba.size());
+        return true;
+    }
+    if (format != TEXFMT_BC1 && format != TEXFMT_BC3) return false;
+
+    size_t blockBytes = format == TEXFMT_BC3 ? 16 : 8;
+    const unsigned char* b = level.data;
+    for (int by = 0; by < level.height; by += 4)
+    {
+        for (int bx = 0; bx < level.width; bx += 4, b += blockBytes)
+        {
+            unsigned char px[16][4];
+            if (format == TEXFMT_BC3)
+            {
+                DecodeColorBlock(b + 8, true, px);
+                DecodeAlphaBlock(b, px);
+            }
+            else
+                DecodeColorBlock(b, false, px);
+
+            // Ivicni blokovi izlaze van slike
+            for (int y = 0; y < 4 && by + y < level.height; y++)
+                for (int x = 0; x < 4 && bx + x < level.width; x++)
+                    std::memcpy(&rgba[(((size_t)(by + y) * level.width) + bx + x) * 4], px[y * 4 + x], 4);
+        }
+    }
+    return true;
+}
+
+static bool FindSourceStamp(const unsigned char* kv, size_t kvSize, SourceStamp& out)
+{
+    size_t pos = 0;
+    while (pos + 4 <= kvSize)
+    {
+        uint32_t len;
+        std::memcpy(&len, kv + pos, 4);
+        pos += 4;
+        if (len > kvSize - pos) return false;
+
+        const char* key = (const char*)(kv + pos);
+        size_t keyLen = strnlen(key, len);
+        if (keyLen + 1 + sizeof(SourceStamp) <= len && std::strcmp(key, KEY_SOURCE) == 0)
+        {
+            std::memcpy(&out, kv + pos + keyLen + 1, sizeof(SourceStamp));
+            return true;
+        }
+        pos += Align4(len);
+    }
+    return false;
+}
+
+static bool ParseTextureFile(const unsigned char* data, size_t size, const SourceStamp& src, TextureFile& out)
+{
+    if (size < sizeof(KtxHeader)) return false;
+
+    KtxHeader h;
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0) return false;
+    if (h.endianness != KTX_ENDIAN) return false;
+    if (h.glInternalFormat != TEXFMT_BC1 && h.glInternalFormat != TEXFMT_BC3 && h.glInternalFormat != TEXFMT_RGBA8) return false;
+    if (h.pixelDepth != 0 || h.numberOfArrayElements != 0 || h.numberOfFaces != 1) return false;
+    if (h.pixelWidth == 0 || h.pixelHeight == 0 || h.numberOfMipmapLevels == 0) return false;
+    if (h.bytesOfKeyValueData > size - sizeof(KtxHeader)) return false;
+
+    SourceStamp stamp;
+    if (!FindSourceStamp(data + sizeof(KtxHeader), h.bytesOfKeyValueData, stamp)) return false;
+    if (stamp.size != src.size || stamp.hash != src.hash) return false;
+
+    out.format = h.glInternalFormat;
+    out.width = (int)h.pixelWidth;
+    out.height = (int)h.pixelHeight;
+    out.levels.clear();
+
+    size_t pos = sizeof(KtxHeader) + h.bytesOfKeyValueData;
+    int w = out.width, hgt = out.height;
+    for (uint32_t i = 0; i < h.numberOfMipmapLevels; i++)
+    {
+        if (pos + 4 > size) return false;
+        uint32_t imageSize;
+        std::memcpy(&imageSize, data + pos, 4);
+        pos += 4;
+        if (imageSize != TextureLevelSize(out.format, w, hgt) || imageSize > size - pos) return false;
+
+        TextureLevel l;
+        l.data = data + pos;
+        l.size = imageSize;
+        l.width = w;
+        l.height = hgt;
+        out.levels.push_back(l);
+
+        pos += Align4(imageSize);
+        w = w > 1 ? w / 2 : 1;
+        hgt = hgt > 1 ? hgt / 2 : 1;
+    }
+    return true;
+}
+
+bool OpenTextureFile(const char* srcPath, TextureFile& out)
+{
+    std::string path = TextureFilePath(srcPath);
+
+    if (const ArchiveEntry* src = gArchive.Find(srcPath))
+    {
+        const ArchiveEntry* ktx = gArchive.Find(path.c_str());
+        if (!ktx) return false;
+        return ParseTextureFile(gArchive.Data(*ktx), (size_t)ktx->size, { src->size, src->contentHash }, out);
+    }
+
+    MappedFile f;
+    if (!f.Open(path.c_str())) return false;
+
+    // Hes izvora se racuna svaki put - i dalje mnogo jeftinije od dekodiranja PNG/JPG
+    MappedFile srcFile;
+    if (!srcFile.Open(srcPath)) return false;
+    SourceStamp src { srcFile.Size(), Fnv1a64(srcFile.Data(), srcFile.Size()) };
+
+    if (!ParseTextureFile(f.Data(), f.Size(), src, out)) return false;
+    out.file = std::move(f);
+    return true;
+}
+
+static void WriteKeyValue(std::string& kv, const char* key, const void* value, size_t valueSize)
+{
+    uint32_t len = (uint32_t)(std::strlen(key) + 1 + valueSize);
+    kv.append((const char*)&len, 4);
+    kv.append(key, std::strlen(key) + 1);
+    kv.append((const char*)value, valueSize);
+    kv.append(Align4(len) - len, '\0');
+}
+
+bool WriteTextureFile(const char* path, uint32_t format, int width, int height,
+                      const std::vector<std::vector<unsigned char>>& levels,
+                      uint64_t srcSize, uint64_t srcHash)
+{
+    bool compressed = format == TEXFMT_BC1 || format == TEXFMT_BC3;
+
+    KtxHeader h{};
+    std::memcpy(h.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER));
+    h.endianness = KTX_ENDIAN;
+    h.glType = compressed ? 0 : 0x1401;      // GL_UNSIGNED_BYTE
+    h.glTypeSize = 1;
+    h.glFormat = compressed ? 0 : 0x1908;    // GL_RGBA
+    h.glInternalFormat = format;
+    h.glBaseInternalFormat = format == TEXFMT_BC1 ? 0x1907 : 0x1908; // GL_RGB / GL_RGBA
+    h.pixelWidth = (uint32_t)width;
+    h.pixelHeight = (uint32_t)height;
+    h.numberOfFaces = 1;
+    h.numberOfMipmapLevels = (uint32_t)levels.size();
+
+    std::string kv;
+    SourceStamp stamp { srcSize, srcHash };
+    WriteKeyValue(kv, KEY_SOURCE, &stamp, sizeof(stamp));
+    // Redovi su odozdo nagore (S desno, T gore)
+    WriteKeyValue(kv, KEY_ORIENTATION, "S=r,T=u", 8);
+    h.bytesOfKeyValueData = (uint32_t)kv.size();
+
+    size_t tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+    std::string tmpPath = std::string(path) + "." + std::to_string(tid) + ".tmp";
+
+    {
+        std::ofstream o(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!o) return false;
+        o.write((const char*)&h, sizeof(h));
+        o.write(kv.data(), (std::streamsize)kv.size());
+
+        static const char zeros[4] = {};
+        for (const std::vector<unsigned char>& level : levels)
+        {
+            uint32_t imageSize = (uint32_t)level.size();
+            o.write((const char*)&imageSize, 4);
+            o.write((const char*)level.data(), (std::streamsize)level.size());
+            o.write(zeros, (std::streamsize)(Align4(level.size()) - level.size()));
+        }
+        if (!o) { o.close(); std::remove(tmpPath.c_str()); return false; }
+    }
+
+    std::remove(path);
+    return std::rename(tmpPath.c_str(), path) == 0;
+}
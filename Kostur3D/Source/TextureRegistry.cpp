@@ -0,0 +1,459 @@
+#include "Header/TextureRegistry.h"
+#include "Header/AssetArchive.h"
+#include "Util.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+TextureRegistry gTextures;
+
+// Poslednjih 7 nivoa (64x64 i manje) su uvek u memoriji, pa tekstura nikad ne nestaje
+static constexpr int TAIL_LEVELS = 7;
+// Najvise zahteva za ucitavanje nivoa po frejmu
+static constexpr int MAX_STREAM_INS = 4;
+
+TextureRegistry::Entry* TextureRegistry::Resolve(TextureHandle h)
+{
+    if (!h.Valid() || h.index >= entries.size()) return nullptr;
+    Entry& e = entries[h.index];
+    return (e.generation == h.generation && e.refs > 0) ? &e : nullptr;
+}
+
+const TextureRegistry::Entry* TextureRegistry::Resolve(TextureHandle h) const
+{
+    return const_cast<TextureRegistry*>(this)->Resolve(h);
+}
+
+TextureHandle TextureRegistry::Acquire(const std::string& path)
+{
+    std::string key = NormalizeAssetPath(path.c_str());
+
+    auto it = lookup.find(key);
+    if (it != lookup.end())
+    {
+        Entry& e = entries[it->second];
+        e.refs++;
+        return { it->second, e.generation };
+    }
+
+    uint32_t index;
+    if (!freeSlots.empty())
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)entries.size();
+        entries.emplace_back();
+    }
+
+    Entry& e = entries[index];
+    uint32_t generation = e.generation;
+    e = Entry();
+    e.generation = generation;
+    e.path = key;
+    e.refs = 1;
+
+    lookup.emplace(key, index);
+    return { index, generation };
+}
+
+void TextureRegistry::AddRef(TextureHandle h)
+{
+    if (Entry* e = Resolve(h)) e->refs++;
+}
+
+void TextureRegistry::Release(TextureHandle& h)
+{
+    Entry* e = Resolve(h);
+    h = TextureHandle();
+    if (!e || --e->refs > 0) return;
+
+    if (e->tex)
+    {
+        byTex.erase(e->tex);
+        glDeleteTextures(1, &e->tex);
+    }
+    residentBytes -= e->bytes;
+    lookup.erase(e->path);
+
+    uint32_t index = (uint32_t)(e - entries.data());
+    e->path.clear();
+    e->tex = 0;
+    e->bytes = 0;
+    e->state = State::Empty;
+    e->generation++;
+    if (e->generation == 0) e->generation = 1;
+    freeSlots.push_back(index);
+}
+
+TextureHandle TextureRegistry::Load(const std::string& path)
+{
+    TextureHandle h = Acquire(path);
+    Entry* e = Resolve(h);
+    if (e->state == State::Empty)
+    {
+        TextureFile file;
+        if (OpenTextureFile(e->path.c_str(), file))
+        {
+            Upload(h, file);
+            return h;
+        }
+
+        int w = 0, hgt = 0;
+        unsigned char* pixels = decodeImage(e->path.c_str(), &w, &hgt);
+        Upload(h, pixels, w, hgt);
+        if (pixels) freeImage(pixels);
+    }
+    return h;
+}
+
+void TextureRegistry::Upload(TextureHandle h, const unsigned char* pixels, int width, int height)
+{
+    Entry* e = Resolve(h);
+    if (!e || e->state == State::Loaded) return;
+
+    if (!pixels)
+    {
+        e->state = State::Failed;
+        return;
+    }
+
+    e->tex = uploadImageToTexture(pixels, width, height);
+    e->width = width;
+    e->height = height;
+    e->format = TEXFMT_RGBA8;
+    // Neispecena slika: lanac mipmapa pravi GPU (KosturTexBake ga pravi unapred)
+    e->bytes = (size_t)width * (size_t)height * 4 * 4 / 3;
+
+    glBindTexture(GL_TEXTURE_2D, e->tex);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    Finish(*e);
+}
+
+void TextureRegistry::Upload(TextureHandle h, const TextureFile& file)
+{
+    Entry* e = Resolve(h);
+    if (!e || e->state == State::Loaded) return;
+
+    if (file.Compressed() && !GLEW_EXT_texture_compression_s3tc)
+    {
+        std::cout << "[TEX] S3TC nije podrzan, dekodira se izvor: " << e->path << "\n";
+        // Nivoi mogu biti u PBO-u; izvor se salje iz CPU memorije
+        GLint unpack = 0;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpack);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        int w = 0, hgt = 0;
+        unsigned char* pixels = decodeImage(e->path.c_str(), &w, &hgt);
+        Upload(h, pixels, w, hgt);
+        if (pixels) freeImage(pixels);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)unpack);
+        return;
+    }
+
+    e->width = file.width;
+    e->height = file.height;
+    e->format = file.format;
+    // Samo ispeceni lanac moze kasnije da se ucita od drugog nivoa
+    e->streamable = file.levels.size() > 1;
+    UploadLevels(*e, file, 0);
+    Finish(*e);
+}
+
+void TextureRegistry::UploadArray(TextureHandle h, const TextureFile& file, int layers)
+{
+    Entry* e = Resolve(h);
+    if (!e || e->state == State::Loaded) return;
+
+    if (file.levels.empty() || file.format != TEXFMT_RGBA8 || layers <= 0)
+    {
+        e->state = State::Failed;
+        return;
+    }
+
+    glGenTextures(1, &e->tex);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, e->tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    e->bytes = 0;
+    for (size_t i = 0; i < file.levels.size(); i++)
+    {
+        const TextureLevel& l = file.levels[i];
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, (GLint)i, GL_RGBA8, l.width, l.height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, l.data);
+        e->bytes += l.size;
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, (GLint)file.levels.size() - 1);
+
+    e->width = file.width;
+    e->height = file.height;
+    e->format = file.format;
+    e->layers = layers;
+    e->levelCount = (int)file.levels.size();
+    Finish(*e, GL_TEXTURE_2D_ARRAY);
+}
+
+// file.levels[0] je mip topLevel originala; nova GL tekstura ide u e.tex
+void TextureRegistry::UploadLevels(Entry& e, const TextureFile& file, int topLevel)
+{
+    size_t levelCount = file.levels.size();
+
+    glGenTextures(1, &e.tex);
+    glBindTexture(GL_TEXTURE_2D, e.tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    e.bytes = 0;
+    for (size_t i = 0; i < levelCount; i++)
+    {
+        const TextureLevel& l = file.levels[i];
+        if (file.Compressed())
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, file.format, l.width, l.height, 0, (GLsizei)l.size, l.data);
+        else
+            glTexImage2D(GL_TEXTURE_2D, (GLint)i, GL_RGBA8, l.width, l.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, l.data);
+        e.bytes += l.size;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    if (levelCount == 1 && !file.Compressed() && topLevel == 0)
+    {
+        // Dekodirana slika (npr. iz PBO-a) - lanac pravi GPU
+        glGenerateMipmap(GL_TEXTURE_2D);
+        e.bytes = e.bytes * 4 / 3;
+    }
+    else
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)levelCount - 1);
+
+    e.topLevel = topLevel;
+    e.levelCount = topLevel + (int)levelCount;
+}
+
+// Zajednicki kraj uploada; tekstura je vezana na target.
+// Parametri teksture vaze samo kad na jedinici nema sampler objekta.
+void TextureRegistry::Finish(Entry& e, GLenum target)
+{
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(target, 0);
+
+    residentBytes += e.bytes;
+    byTex[e.tex] = (uint32_t)(&e - entries.data());
+    // Sveze ucitana tekstura se ne izbacuje pre nego sto je iko nacrta
+    e.lastUsed = frame;
+    e.state = State::Loaded;
+}
+
+void TextureRegistry::Restream(TextureHandle h, const TextureFile& file, int topLevel)
+{
+    Entry* e = Resolve(h);
+    if (!e) return;
+    e->pendingLevel = -1;
+    if (e->state != State::Loaded || !e->streamable || file.format != e->format || file.levels.empty()) return;
+
+    // Nova tekstura umesto menjanja postojece: manji lanac stvarno oslobadja memoriju,
+    // a GPU moze jos da crta staru dok se nova puni
+    GLuint old = e->tex;
+    byTex.erase(old);
+    residentBytes -= e->bytes;
+
+    UploadLevels(*e, file, topLevel);
+    glDeleteTextures(1, &old);
+    Finish(*e);
+}
+
+void TextureRegistry::CancelStream(TextureHandle h)
+{
+    if (Entry* e = Resolve(h)) e->pendingLevel = -1;
+}
+
+size_t TextureRegistry::ChainBytes(const Entry& e, int topLevel) const
+{
+    size_t bytes = 0;
+    for (int i = topLevel; i < e.levelCount; i++)
+        bytes += TextureLevelSize(e.format, std::max(1, e.width >> i), std::max(1, e.height >> i));
+    return bytes;
+}
+
+void TextureRegistry::NoteUse(Entry& e, float projectedPixels)
+{
+    // Nivo na kome je jedan teksel otprilike jedan piksel
+    int tail = std::max(0, e.levelCount - TAIL_LEVELS);
+    float size = (float)std::max(e.width, e.height);
+    int level = tail;
+    if (projectedPixels >= size)
+        level = 0;
+    else if (projectedPixels > 0.0f)
+        level = std::min(tail, (int)std::floor(std::log2(size / projectedPixels)));
+
+    if (e.lastUsed != frame)
+    {
+        e.lastUsed = frame;
+        e.wantedLevel = level;
+    }
+    else
+        e.wantedLevel = std::min(e.wantedLevel, level);
+}
+
+void TextureRegistry::NoteUse(TextureHandle h, float projectedPixels)
+{
+    Entry* e = Resolve(h);
+    if (e && e->state == State::Loaded) NoteUse(*e, projectedPixels);
+}
+
+void TextureRegistry::NoteUse(GLuint tex, float projectedPixels)
+{
+    auto it = byTex.find(tex);
+    if (it != byTex.end()) NoteUse(entries[it->second], projectedPixels);
+}
+
+void TextureRegistry::UpdateStreaming(std::vector<std::pair<TextureHandle, int>>& requests)
+{
+    // Memorija kakva ce biti kad se zavrse vec zadati zahtevi
+    size_t projected = 0;
+    std::vector<uint32_t> streamable;
+    for (const auto& kv : lookup)
+    {
+        const Entry& e = entries[kv.second];
+        if (e.state != State::Loaded) continue;
+        if (!e.streamable)
+        {
+            projected += e.bytes;
+            continue;
+        }
+        projected += ChainBytes(e, e.pendingLevel >= 0 ? e.pendingLevel : e.topLevel);
+        streamable.push_back(kv.second);
+    }
+
+    auto request = [&](uint32_t index, int level)
+    {
+        Entry& e = entries[index];
+        projected = projected - ChainBytes(e, e.topLevel) + ChainBytes(e, level);
+        e.pendingLevel = level;
+        requests.push_back({ { index, e.generation }, level });
+    };
+
+    if (budgetBytes && projected > budgetBytes)
+    {
+        // LRU: prvo najduze nekoriscene, medju istima najvece
+        std::sort(streamable.begin(), streamable.end(), [&](uint32_t a, uint32_t b)
+        {
+            const Entry& ea = entries[a];
+            const Entry& eb = entries[b];
+            if (ea.lastUsed != eb.lastUsed) return ea.lastUsed < eb.lastUsed;
+            return ea.bytes > eb.bytes;
+        });
+
+        // Prvo se skida sve sto je iznad potrebnog nivoa (nekoriscene do repa)
+        for (uint32_t index : streamable)
+        {
+            if (projected <= budgetBytes) break;
+            const Entry& e = entries[index];
+            int tail = std::max(0, e.levelCount - TAIL_LEVELS);
+            int target = e.lastUsed == frame ? e.wantedLevel : tail;
+            if (e.pendingLevel < 0 && target > e.topLevel) request(index, target);
+        }
+        // Ako ni to nije dovoljno, i vidljive teksture gube po jedan nivo
+        for (uint32_t index : streamable)
+        {
+            if (projected <= budgetBytes) break;
+            const Entry& e = entries[index];
+            int tail = std::max(0, e.levelCount - TAIL_LEVELS);
+            if (e.pendingLevel < 0 && e.topLevel < tail) request(index, e.topLevel + 1);
+        }
+    }
+    else
+    {
+        // Ucitavanje finijih nivoa za ono sto je nacrtano ovog frejma, dok staje u budzet
+        int count = 0;
+        for (uint32_t index : streamable)
+        {
+            if (count >= MAX_STREAM_INS) break;
+            const Entry& e = entries[index];
+            if (e.lastUsed != frame || e.pendingLevel >= 0 || e.wantedLevel >= e.topLevel) continue;
+
+            size_t extra = ChainBytes(e, e.wantedLevel) - ChainBytes(e, e.topLevel);
+            if (budgetBytes && projected + extra > budgetBytes) continue;
+            request(index, e.wantedLevel);
+            count++;
+        }
+    }
+}
+
+void TextureRegistry::MarkQueued(TextureHandle h)
+{
+    if (Entry* e = Resolve(h))
+        if (e->state == State::Empty) e->state = State::Queued;
+}
+
+TextureRegistry::State TextureRegistry::GetState(TextureHandle h) const
+{
+    const Entry* e = Resolve(h);
+    return e ? e->state : State::Failed;
+}
+
+const std::string& TextureRegistry::Path(TextureHandle h) const
+{
+    static const std::string none;
+    const Entry* e = Resolve(h);
+    return e ? e->path : none;
+}
+
+GLuint TextureRegistry::Get(TextureHandle h)
+{
+    const Entry* e = Resolve(h);
+    if (e && e->state == State::Loaded) return e->tex;
+    return White();
+}
+
+GLuint TextureRegistry::White()
+{
+    if (!white)
+    {
+        unsigned char px[4] = { 255, 255, 255, 255 };
+        glGenTextures(1, &white);
+        glBindTexture(GL_TEXTURE_2D, white);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, px);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    return white;
+}
+
+void TextureRegistry::PrintStats() const
+{
+    std::cout << "[TEX] " << lookup.size() << " textures, " << residentBytes / 1024 << " KB";
+    if (budgetBytes) std::cout << " (budzet " << budgetBytes / 1024 << " KB)";
+    std::cout << "\n";
+    for (const auto& kv : lookup)
+    {
+        const Entry& e = entries[kv.second];
+        const char* format = e.format == TEXFMT_BC1 ? " BC1" : e.format == TEXFMT_BC3 ? " BC3" : "";
+        std::cout << "    " << e.path << format
+                  << " | " << e.width << "x" << e.height;
+        if (e.layers > 1) std::cout << "x" << e.layers;
+        std::cout << " | refs " << e.refs;
+        if (e.streamable)
+            std::cout << " | mip " << e.topLevel << "/" << e.levelCount
+                      << " (" << std::max(1, e.width >> e.topLevel) << "x" << std::max(1, e.height >> e.topLevel) << ")";
+        std::cout << "\n";
+    }
+}
+
+void TextureRegistry::Clear()
+{
+    for (const auto& kv : lookup)
+    {
+        Entry& e = entries[kv.second];
+        std::cout << "[TEX LEAK] " << e.path << " | refs " << e.refs << "\n";
+        if (e.tex) glDeleteTextures(1, &e.tex);
+    }
+
+    if (white) glDeleteTextures(1, &white);
+    white = 0;
+
+    entries.clear();
+    freeSlots.clear();
+    lookup.clear();
+    byTex.clear();
+    residentBytes = 0;
+}
@@ -0,0 +1,170 @@
+#include "Header/UploadRing.h"
+#include <iostream>
+
+UploadRing gUploadRing;
+
+bool UploadRing::MapSlot(Slot& s)
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s.pbo);
+    // Fence je prosao pa stari sadrzaj vise nikome ne treba
+    s.ptr = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)slotBytes,
+                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return s.ptr != nullptr;
+}
+
+bool UploadRing::Init(int slotCount, size_t bytesPerSlot)
+{
+    Destroy();
+
+    slotBytes = bytesPerSlot;
+    slots.resize((size_t)slotCount);
+    persistent = GLEW_ARB_buffer_storage != 0;
+
+    if (persistent)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr total = (GLsizeiptr)(slotBytes * slots.size());
+
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, total, nullptr, flags);
+        unsigned char* base = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, total, flags);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (!base)
+        {
+            Destroy();
+            return false;
+        }
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            slots[i].pbo = buffer;
+            slots[i].offset = i * slotBytes;
+            slots[i].ptr = base + i * slotBytes;
+        }
+    }
+    else
+    {
+        for (Slot& s : slots)
+        {
+            glGenBuffers(1, &s.pbo);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s.pbo);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)slotBytes, nullptr, GL_STREAM_DRAW);
+            if (!MapSlot(s))
+            {
+                Destroy();
+                return false;
+            }
+        }
+    }
+
+    std::cout << "[UPLOAD] " << slots.size() << " x " << (slotBytes >> 20) << " MB PBO slotova"
+              << (persistent ? " (trajno mapirano)" : " (mapiranje po slotu)") << "\n";
+    return true;
+}
+
+void UploadRing::Destroy()
+{
+    for (Slot& s : slots)
+    {
+        if (s.fence) glDeleteSync(s.fence);
+        if (!persistent && s.pbo)
+        {
+            if (s.ptr)
+            {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s.pbo);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+            glDeleteBuffers(1, &s.pbo);
+        }
+    }
+    // Brisanje bafera ga i odmapira
+    if (buffer) glDeleteBuffers(1, &buffer);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    slots.clear();
+    buffer = 0;
+}
+
+bool UploadRing::TryAcquire(size_t bytes, UploadSlot& out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bytes <= slotBytes)
+    {
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            Slot& s = slots[i];
+            if (s.state != SlotState::Free || !s.ptr) continue;
+
+            s.state = SlotState::Writing;
+            out.index = (int)i;
+            out.ptr = s.ptr;
+            out.offset = s.offset;
+            out.size = bytes;
+            acquired++;
+            return true;
+        }
+    }
+    rejected++;
+    return false;
+}
+
+void UploadRing::Cancel(UploadSlot& s)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (s.Valid() && s.index < (int)slots.size() && slots[s.index].state == SlotState::Writing)
+        slots[s.index].state = SlotState::Free;
+    s = UploadSlot();
+}
+
+void UploadRing::BeginCopy(const UploadSlot& us)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Slot& s = slots[us.index];
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s.pbo);
+    if (!persistent)
+    {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        s.ptr = nullptr;
+    }
+    s.state = SlotState::Copying;
+}
+
+void UploadRing::EndCopy(UploadSlot& us)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Slot& s = slots[us.index];
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s.state = SlotState::InFlight;
+    us = UploadSlot();
+}
+
+void UploadRing::Update()
+{
+    // Radne niti za to vreme samo cekaju na TryAcquire; provera fence-a sa timeout 0 ne blokira
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Slot& s : slots)
+    {
+        if (s.state != SlotState::InFlight) continue;
+
+        if (s.fence)
+        {
+            GLenum r = glClientWaitSync(s.fence, 0, 0);
+            if (r != GL_ALREADY_SIGNALED && r != GL_CONDITION_SATISFIED) continue;
+
+            glDeleteSync(s.fence);
+            s.fence = nullptr;
+        }
+        // Ako mapiranje ne uspe, pokusava se ponovo sledeceg frejma
+        if (!persistent && !MapSlot(s)) continue;
+        s.state = SlotState::Free;
+    }
+}
+
+void UploadRing::PrintStats() const
+{
+    std::cout << "[UPLOAD] kroz PBO " << acquired << ", direktno " << rejected << "\n";
+}
@@ -0,0 +1,194 @@
+// KosturPack: pakuje res/ (i ostale zadate fajlove) u jednu arhivu koju cita AssetArchive.
+// Upotreba: KosturPack <izlaz.kpak> [--raw-images] <fajl ili direktorijum>...
+// Logicka putanja je putanja kako je zadata (npr. "res/wall.png"), pa se alat pokrece iz direktorijuma aplikacije.
+// Postojeci .meshbin kesevi se pakuju uz OBJ, pa je dobro jednom pokrenuti aplikaciju pre pakovanja.
+// Slika koja ima ispeceni .ktx (KosturTexBake) ostaje nedekodirana - koristi se .ktx, a izvor samo za proveru.
+#include "Header/AssetArchive.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace fs = std::filesystem;
+
+struct PackItem {
+    std::string logical;
+    fs::path source;
+};
+
+static bool IsImage(const fs::path& p)
+{
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+}
+
+static bool Skip(const fs::path& p)
+{
+    std::string name = p.filename().string();
+    return name == ".DS_Store" || p.extension() == ".tmp";
+}
+
+static void Collect(const std::string& input, std::vector<PackItem>& out)
+{
+    fs::path root(input);
+    if (fs::is_directory(root))
+    {
+        for (const auto& e : fs::recursive_directory_iterator(root))
+        {
+            if (!e.is_regular_file() || Skip(e.path())) continue;
+            out.push_back({ NormalizeAssetPath(e.path().generic_string().c_str()), e.path() });
+        }
+    }
+    else if (fs::is_regular_file(root))
+    {
+        out.push_back({ NormalizeAssetPath(root.generic_string().c_str()), root });
+    }
+    else
+    {
+        std::cout << "[PACK] preskacem nepostojece: " << input << "\n";
+    }
+}
+
+static bool ReadFile(const fs::path& p, std::vector<unsigned char>& out)
+{
+    std::ifstream in(p, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static void Pad(std::ofstream& o, uint64_t& offset)
+{
+    static const char zeros[ARCHIVE_ALIGN] = {};
+    uint64_t pad = (ARCHIVE_ALIGN - offset % ARCHIVE_ALIGN) % ARCHIVE_ALIGN;
+    o.write(zeros, (std::streamsize)pad);
+    offset += pad;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cout << "Upotreba: KosturPack <izlaz.kpak> [--raw-images] <fajl ili direktorijum>...\n";
+        return 1;
+    }
+
+    const char* outPath = argv[1];
+    bool decodeImages = true;
+    std::vector<PackItem> items;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--raw-images") == 0) { decodeImages = false; continue; }
+        Collect(argv[i], items);
+    }
+
+    std::sort(items.begin(), items.end(), [](const PackItem& a, const PackItem& b) { return a.logical < b.logical; });
+    items.erase(std::unique(items.begin(), items.end(), [](const PackItem& a, const PackItem& b) { return a.logical == b.logical; }), items.end());
+
+    std::string tmpPath = std::string(outPath) + ".tmp";
+    std::ofstream o(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!o)
+    {
+        std::cout << "[PACK] ne mogu da otvorim " << tmpPath << "\n";
+        return 2;
+    }
+
+    ArchiveHeader h{};
+    std::memcpy(h.magic, ARCHIVE_MAGIC, 4);
+    h.version = ARCHIVE_VERSION;
+    o.write((const char*)&h, sizeof(h));
+    uint64_t offset = sizeof(h);
+
+    std::vector<ArchiveEntry> toc;
+    std::string names;
+    uint64_t rawBytes = 0;
+
+    // Isto kao decodeImage u aplikaciji
+    stbi_set_flip_vertically_on_load(true);
+
+    for (const PackItem& item : items)
+    {
+        std::vector<unsigned char> bytes;
+        if (!ReadFile(item.source, bytes))
+        {
+            std::cout << "[PACK] greska pri citanju " << item.source << "\n";
+            return 3;
+        }
+        rawBytes += bytes.size();
+
+        ArchiveEntry e{};
+        e.pathHash = Fnv1a64(item.logical.data(), item.logical.size());
+        e.contentHash = Fnv1a64(bytes.data(), bytes.size());
+        e.nameOffset = (uint32_t)names.size();
+        e.nameLength = (uint32_t)item.logical.size();
+        e.kind = ArchiveKind::Raw;
+        names += item.logical;
+        names.push_back('\0');
+
+        const unsigned char* payload = bytes.data();
+        size_t payloadSize = bytes.size();
+        unsigned char* pixels = nullptr;
+
+        bool baked = fs::exists(item.source.string() + ".ktx");
+        if (decodeImages && !baked && IsImage(item.source))
+        {
+            int w = 0, hgt = 0, ch = 0;
+            pixels = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &w, &hgt, &ch, STBI_rgb_alpha);
+            if (pixels)
+            {
+                e.kind = ArchiveKind::ImageRGBA8;
+                e.width = (uint32_t)w;
+                e.height = (uint32_t)hgt;
+                payload = pixels;
+                payloadSize = (size_t)w * (size_t)hgt * 4;
+            }
+        }
+
+        Pad(o, offset);
+        e.offset = offset;
+        e.size = payloadSize;
+        o.write((const char*)payload, (std::streamsize)payloadSize);
+        offset += payloadSize;
+
+        if (pixels) stbi_image_free(pixels);
+        toc.push_back(e);
+    }
+
+    std::stable_sort(toc.begin(), toc.end(), [](const ArchiveEntry& a, const ArchiveEntry& b) { return a.pathHash < b.pathHash; });
+
+    Pad(o, offset);
+    h.entryCount = (uint32_t)toc.size();
+    h.tocOffset = offset;
+    o.write((const char*)toc.data(), (std::streamsize)(toc.size() * sizeof(ArchiveEntry)));
+    offset += toc.size() * sizeof(ArchiveEntry);
+
+    h.namesOffset = offset;
+    o.write(names.data(), (std::streamsize)names.size());
+    offset += names.size();
+
+    o.seekp(0);
+    o.write((const char*)&h, sizeof(h));
+    o.close();
+    if (!o)
+    {
+        std::remove(tmpPath.c_str());
+        return 4;
+    }
+
+    std::remove(outPath);
+    if (std::rename(tmpPath.c_str(), outPath) != 0)
+        return 5;
+
+    std::cout << "[PACK] " << outPath << " | " << toc.size() << " entries, "
+              << rawBytes / 1024 << " KB izvora -> " << offset / 1024 << " KB\n";
+    return 0;
+}
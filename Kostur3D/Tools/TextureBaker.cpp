@@ -0,0 +1,341 @@
+// KosturTexBake: pravi <slika>.ktx pored svake slike, sa celim lancem mipmapa u BC1 (bez alfe)
+// ili BC3 (sa alfom). Sa --rgba nivoi ostaju nekompresovani (samo se preskace dekodiranje).
+// Upotreba: KosturTexBake [--rgba] [--force] <fajl ili direktorijum>...
+// Fajl koji vec odgovara izvoru (isti hes) se preskace, pa je alat bezbedno pokretati pri svakom build-u.
+#include "Header/AssetArchive.h"
+#include "Header/TextureFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace fs = std::filesystem;
+
+static bool IsImage(const fs::path& p)
+{
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+}
+
+static void Collect(const std::string& input, std::vector<fs::path>& out)
+{
+    fs::path root(input);
+    if (fs::is_directory(root))
+    {
+        for (const auto& e : fs::recursive_directory_iterator(root))
+            if (e.is_regular_file() && IsImage(e.path())) out.push_back(e.path());
+    }
+    else if (fs::is_regular_file(root) && IsImage(root))
+        out.push_back(root);
+    else
+        std::cout << "[BAKE] preskacem: " << input << "\n";
+}
+
+// ---------- Mipmape ----------
+
+struct Image {
+    int w = 0, h = 0;
+    std::vector<unsigned char> px;
+};
+
+// 2x2 box filter; kod neparne dimenzije poslednja kolona/red se ponavlja
+static Image Downsample(const Image& src)
+{
+    Image dst;
+    dst.w = std::max(1, src.w / 2);
+    dst.h = std::max(1, src.h / 2);
+    dst.px.resize((size_t)dst.w * dst.h * 4);
+
+    for (int y = 0; y < dst.h; y++)
+    {
+        int y0 = std::min(y * 2, src.h - 1), y1 = std::min(y * 2 + 1, src.h - 1);
+        for (int x = 0; x < dst.w; x++)
+        {
+            int x0 = std::min(x * 2, src.w - 1), x1 = std::min(x * 2 + 1, src.w - 1);
+            for (int c = 0; c < 4; c++)
+            {
+                int sum = src.px[((size_t)y0 * src.w + x0) * 4 + c] + src.px[((size_t)y0 * src.w + x1) * 4 + c]
+                        + src.px[((size_t)y1 * src.w + x0) * 4 + c] + src.px[((size_t)y1 * src.w + x1) * 4 + c];
+                dst.px[((size_t)y * dst.w + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+// ---------- BC1 / BC3 ----------
+
+static uint16_t To565(const float c[3])
+{
+    int r = (int)std::lround(std::clamp(c[0], 0.0f, 255.0f) * 31.0f / 255.0f);
+    int g = (int)std::lround(std::clamp(c[1], 0.0f, 255.0f) * 63.0f / 255.0f);
+    int b = (int)std::lround(std::clamp(c[2], 0.0f, 255.0f) * 31.0f / 255.0f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void From565(uint16_t v, int out[3])
+{
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+// Krajnje tacke po glavnoj osi boja (range fit), uvek rezim sa 4 boje
+static void EncodeColorBlock(const unsigned char block[16 * 4], unsigned char out[8])
+{
+    float mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+        for (int c = 0; c < 3; c++) mean[c] += block[i * 4 + c] / 16.0f;
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        float d[3] = { block[i * 4] - mean[0], block[i * 4 + 1] - mean[1], block[i * 4 + 2] - mean[2] };
+        cov[0] += d[0] * d[0]; cov[1] += d[0] * d[1]; cov[2] += d[0] * d[2];
+        cov[3] += d[1] * d[1]; cov[4] += d[1] * d[2]; cov[5] += d[2] * d[2];
+    }
+
+    float axis[3] = { 1, 1, 1 };
+    for (int it = 0; it < 8; it++)
+    {
+        float n[3] = {
+            cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+            cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+            cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]
+        };
+        float len = std::max({ std::fabs(n[0]), std::fabs(n[1]), std::fabs(n[2]) });
+        if (len < 1e-6f) break;
+        for (int c = 0; c < 3; c++) axis[c] = n[c] / len;
+    }
+
+    float tMin = 1e30f, tMax = -1e30f;
+    for (int i = 0; i < 16; i++)
+    {
+        float t = (block[i * 4] - mean[0]) * axis[0] + (block[i * 4 + 1] - mean[1]) * axis[1] + (block[i * 4 + 2] - mean[2]) * axis[2];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+
+    float axisLen2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    if (axisLen2 < 1e-6f) axisLen2 = 1.0f;
+    float hi[3], lo[3];
+    for (int c = 0; c < 3; c++)
+    {
+        hi[c] = mean[c] + axis[c] * tMax / axisLen2;
+        lo[c] = mean[c] + axis[c] * tMin / axisLen2;
+    }
+
+    uint16_t c0 = To565(hi), c1 = To565(lo);
+    if (c0 < c1) std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1)
+    {
+        int p0[3], p1[3], palette[4][3];
+        From565(c0, p0);
+        From565(c1, p1);
+        for (int c = 0; c < 3; c++)
+        {
+            palette[0][c] = p0[c];
+            palette[1][c] = p1[c];
+            palette[2][c] = (2 * p0[c] + p1[c]) / 3;
+            palette[3][c] = (p0[c] + 2 * p1[c]) / 3;
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, bestErr = 1 << 30;
+            for (int k = 0; k < 4; k++)
+            {
+                int dr = block[i * 4] - palette[k][0], dg = block[i * 4 + 1] - palette[k][1], db = block[i * 4 + 2] - palette[k][2];
+                int err = dr * dr + dg * dg + db * db;
+                if (err < bestErr) { bestErr = err; best = k; }
+            }
+            indices |= (uint32_t)best << (i * 2);
+        }
+    }
+
+    std::memcpy(out, &c0, 2);
+    std::memcpy(out + 2, &c1, 2);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+// BC3 alfa: min/max kao krajnje tacke, rezim sa 8 vrednosti
+static void EncodeAlphaBlock(const unsigned char block[16 * 4], unsigned char out[8])
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++)
+    {
+        a0 = std::max(a0, (int)block[i * 4 + 3]);
+        a1 = std::min(a1, (int)block[i * 4 + 3]);
+    }
+
+    uint64_t bits = 0;
+    if (a0 != a1)
+    {
+        int palette[8] = { a0, a1 };
+        for (int k = 2; k < 8; k++)
+            palette[k] = ((8 - k) * a0 + (k - 1) * a1) / 7;
+
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, bestErr = 1 << 30;
+            for (int k = 0; k < 8; k++)
+            {
+                int err = std::abs(block[i * 4 + 3] - palette[k]);
+                if (err < bestErr) { bestErr = err; best = k; }
+            }
+            bits |= (uint64_t)best << (i * 3);
+        }
+    }
+
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+    for (int b = 0; b < 6; b++)
+        out[2 + b] = (unsigned char)(bits >> (b * 8));
+}
+
+static std::vector<unsigned char> CompressLevel(const Image& img, uint32_t format)
+{
+    if (format == TEXFMT_RGBA8) return img.px;
+
+    size_t blockBytes = format == TEXFMT_BC3 ? 16 : 8;
+    int bw = (img.w + 3) / 4, bh = (img.h + 3) / 4;
+    std::vector<unsigned char> out((size_t)bw * bh * blockBytes);
+
+    unsigned char block[16 * 4];
+    for (int by = 0; by < bh; by++)
+    {
+        for (int bx = 0; bx < bw; bx++)
+        {
+            // Blok koji izlazi van slike ponavlja ivicne piksele
+            for (int y = 0; y < 4; y++)
+                for (int x = 0; x < 4; x++)
+                {
+                    int sx = std::min(bx * 4 + x, img.w - 1), sy = std::min(by * 4 + y, img.h - 1);
+                    std::memcpy(block + (y * 4 + x) * 4, &img.px[((size_t)sy * img.w + sx) * 4], 4);
+                }
+
+            unsigned char* dst = &out[((size_t)by * bw + bx) * blockBytes];
+            if (format == TEXFMT_BC3)
+            {
+                EncodeAlphaBlock(block, dst);
+                EncodeColorBlock(block, dst + 8);
+            }
+            else
+                EncodeColorBlock(block, dst);
+        }
+    }
+    return out;
+}
+
+static bool ReadFile(const fs::path& p, std::vector<unsigned char>& out)
+{
+    std::ifstream in(p, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    bool rgba = false, force = false;
+    std::vector<fs::path> inputs;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--rgba") == 0) { rgba = true; continue; }
+        if (std::strcmp(argv[i], "--force") == 0) { force = true; continue; }
+        Collect(argv[i], inputs);
+    }
+
+    if (inputs.empty())
+    {
+        std::cout << "Upotreba: KosturTexBake [--rgba] [--force] <fajl ili direktorijum>...\n";
+        return 1;
+    }
+
+    // Isto kao decodeImage u aplikaciji
+    stbi_set_flip_vertically_on_load(true);
+
+    size_t baked = 0, skipped = 0, failed = 0;
+    uint64_t rawBytes = 0, outBytes = 0;
+
+    for (const fs::path& src : inputs)
+    {
+        std::string srcPath = src.generic_string();
+
+        TextureFile existing;
+        if (!force && OpenTextureFile(srcPath.c_str(), existing))
+        {
+            skipped++;
+            continue;
+        }
+
+        std::vector<unsigned char> bytes;
+        int w = 0, h = 0, ch = 0;
+        unsigned char* pixels = nullptr;
+        if (ReadFile(src, bytes))
+            pixels = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &w, &h, &ch, STBI_rgb_alpha);
+        if (!pixels)
+        {
+            std::cout << "[BAKE] ne mogu da dekodiram " << srcPath << "\n";
+            failed++;
+            continue;
+        }
+
+        Image level;
+        level.w = w;
+        level.h = h;
+        level.px.assign(pixels, pixels + (size_t)w * h * 4);
+        stbi_image_free(pixels);
+
+        bool hasAlpha = false;
+        for (size_t i = 3; i < level.px.size() && !hasAlpha; i += 4)
+            hasAlpha = level.px[i] != 255;
+
+        uint32_t format = rgba ? TEXFMT_RGBA8 : (hasAlpha ? TEXFMT_BC3 : TEXFMT_BC1);
+
+        std::vector<std::vector<unsigned char>> levels;
+        uint64_t levelRaw = 0;
+        for (;;)
+        {
+            levels.push_back(CompressLevel(level, format));
+            levelRaw += (uint64_t)level.w * level.h * 4;
+            if (level.w == 1 && level.h == 1) break;
+            level = Downsample(level);
+        }
+
+        std::string outPath = TextureFilePath(srcPath.c_str());
+        if (!WriteTextureFile(outPath.c_str(), format, w, h, levels, bytes.size(), Fnv1a64(bytes.data(), bytes.size())))
+        {
+            std::cout << "[BAKE] greska pri upisu " << outPath << "\n";
+            failed++;
+            continue;
+        }
+
+        uint64_t levelOut = 0;
+        for (const auto& l : levels) levelOut += l.size();
+        rawBytes += levelRaw;
+        outBytes += levelOut;
+        baked++;
+
+        const char* name = format == TEXFMT_BC1 ? "BC1" : format == TEXFMT_BC3 ? "BC3" : "RGBA8";
+        std::cout << "[BAKE] " << srcPath << " | " << w << "x" << h << " " << name << ", "
+                  << levels.size() << " mip | " << levelRaw / 1024 << " KB -> " << levelOut / 1024 << " KB\n";
+    }
+
+    std::cout << "[BAKE] " << baked << " ispeceno, " << skipped << " vec azurno, " << failed << " gresaka";
+    if (baked) std::cout << " | RGBA8 " << rawBytes / 1024 << " KB -> " << outBytes / 1024 << " KB";
+    std::cout << "\n";
+    return failed ? 2 : 0;
+}
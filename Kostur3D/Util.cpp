@@ -1,4 +1,5 @@
 #include "Util.h"
+#include "Header/AssetArchive.h"
 
 #define _CRT_SECURE_NO_WARNINGS
 #include <fstream>
@@ -17,7 +18,12 @@ unsigned int compileShader(GLenum type, const char* source)
     std::string content = "";
     std::ifstream file(source);
     std::stringstream ss;
-    if (file.is_open())
+    if (const ArchiveEntry* e = gArchive.Find(source))
+    {
+        ss.write((const char*)gArchive.Data(*e), (std::streamsize)e->size);
+        std::cout << "Uspesno procitao fajl iz arhive \"" << source << "\"!" << std::endl;
+    }
+    else if (file.is_open())
     {
         ss << file.rdbuf();
         file.close();
@@ -89,15 +95,40 @@ unsigned int createShader(const char* vsSource, const char* fsSource)
     return program;
 }
 
-unsigned int loadImageToTexture(const char* filePath)
+unsigned char* decodeImage(const char* filePath, int* width, int* height)
 {
-    int w, h, ch;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(filePath, &w, &h, &ch, STBI_rgb_alpha);
-    if (!data) {
-        std::cout << "[TEX FAIL] " << filePath << " | " << stbi_failure_reason() << "\n";
-        return 0;
+    //Moze se zvati sa radnih niti - flip je podesen po niti
+    int ch;
+    stbi_set_flip_vertically_on_load_thread(true);
+
+    unsigned char* data = nullptr;
+    if (const ArchiveEntry* e = gArchive.Find(filePath))
+    {
+        // Vec dekodirano pri pakovanju - pikseli se citaju direktno iz mapirane arhive
+        if (e->kind == ArchiveKind::ImageRGBA8)
+        {
+            *width = (int)e->width;
+            *height = (int)e->height;
+            return const_cast<unsigned char*>(gArchive.Data(*e));
+        }
+        data = stbi_load_from_memory(gArchive.Data(*e), (int)e->size, width, height, &ch, STBI_rgb_alpha);
     }
+    else
+        data = stbi_load(filePath, width, height, &ch, STBI_rgb_alpha);
+    if (!data)
+        std::cout << "[TEX FAIL] " << filePath << " | " << stbi_failure_reason() << "\n";
+    return data;
+}
+
+void freeImage(unsigned char* pixels)
+{
+    if (gArchive.Contains(pixels)) return;
+    stbi_image_free(pixels);
+}
+
+unsigned int uploadImageToTexture(const unsigned char* pixels, int w, int h)
+{
+    if (!pixels) return 0;
 
     GLuint tex = 0;
     glGenTextures(1, &tex);
@@ -106,7 +137,7 @@ unsigned int loadImageToTexture(const char* filePath)
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
     // IMPORTANT on mac: sized internal format
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 
     // IMPORTANT: make texture complete (NO mipmaps)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -115,7 +146,17 @@ unsigned int loadImageToTexture(const char* filePath)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     glBindTexture(GL_TEXTURE_2D, 0);
-    stbi_image_free(data);
+    return tex;
+}
+
+unsigned int loadImageToTexture(const char* filePath)
+{
+    int w, h;
+    unsigned char* data = decodeImage(filePath, &w, &h);
+    if (!data) return 0;
+
+    GLuint tex = uploadImageToTexture(data, w, h);
+    freeImage(data);
     return tex;
 }
 
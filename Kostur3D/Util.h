@@ -3,4 +3,7 @@
 #include <GLFW/glfw3.h>
 unsigned int createShader(const char* vsSource, const char* fsSource);
 unsigned loadImageToTexture(const char* filePath);
+unsigned char* decodeImage(const char* filePath, int* width, int* height);
+void freeImage(unsigned char* pixels);
+unsigned uploadImageToTexture(const unsigned char* pixels, int width, int height);
 GLFWcursor* loadImageToCursor(const char* filePath);
\ No newline at end of file
@@ -4,23 +4,30 @@ in vec4 vColor;
 in vec2 vUV;
 in vec3 vN;
 in vec3 vWorldPos;
+flat in float vLayer;
 
 uniform sampler2D uTex;
-uniform int useTex;
-uniform vec4 uTint;
-
-uniform vec3  uLightPos;
-uniform vec3  uLightColor;
-uniform float uLightPower;
-
-uniform vec3  uLightPos2;
-uniform vec3  uLightColor2;
-uniform float uLightPower2;
-
-uniform float uAmbient;
-
-uniform int uUnlit;
-uniform float uEmissive;
+uniform sampler2DArray uGlyphTex;
+
+// Isti blokovi kao u basic.vert
+layout (std140) uniform Frame {
+    mat4 uV;
+    mat4 uP;
+    vec4 uLightPos;
+    vec4 uLightColor;     // w = snaga
+    vec4 uLightPos2;
+    vec4 uLightColor2;    // w = snaga
+    vec4 uAmbient;        // x
+};
+
+layout (std140) uniform Draw {
+    mat4 uM;
+    vec4 uTint;
+    vec4 uPosScale;
+    vec4 uPosOffset;
+    ivec4 uFlags;         // x useTex, y unlit, z mod
+    vec4 uParams;         // x emissive
+};
 
 out vec4 FragColor;
 
@@ -28,44 +35,50 @@ void main()
 {
     vec4 base = vColor * uTint;
 
-    if (useTex == 1) {
+    if (uFlags.x == 1) {
         vec4 texCol = texture(uTex, vUV);
         if(texCol.a < 0.1) discard;
         base *= texCol;
     }
+    else if (uFlags.x == 2) {
+        vec4 texCol = texture(uGlyphTex, vec3(vUV, vLayer));
+        if(texCol.a < 0.1) discard;
+        base *= texCol;
+    }
 
-    if (uUnlit == 1) {
-        base.rgb += base.rgb * uEmissive;
+    float emissive = uParams.x;
+    if (uFlags.y == 1) {
+        base.rgb += base.rgb * emissive;
         FragColor = base;
         return;
     }
 
     vec3 N = normalize(vN);
 
-    vec3 L1 = normalize(uLightPos - vWorldPos);
+    vec3 L1 = normalize(uLightPos.xyz - vWorldPos);
     float diff1 = max(dot(N, L1), 0.0);
 
-    float dist1 = length(uLightPos - vWorldPos);
+    float dist1 = length(uLightPos.xyz - vWorldPos);
     float att1 = 1.0 / (1.0 + 0.20 * dist1 + 0.05 * dist1 * dist1);
 
     vec3 light1 =
-        (uAmbient + diff1 * uLightPower * att1) *
-        uLightColor;
+        (uAmbient.x + diff1 * uLightColor.w * att1) *
+        uLightColor.rgb;
 
-    vec3 L2 = normalize(uLightPos2 - vWorldPos);
+    vec3 L2 = normalize(uLightPos2.xyz - vWorldPos);
     float diff2 = max(dot(N, L2), 0.0);
 
-    float dist2 = length(uLightPos2 - vWorldPos);
+    float dist2 = length(uLightPos2.xyz - vWorldPos);
     float att2 = 1.0 / (1.0 + 0.30 * dist2 + 0.10 * dist2 * dist2);
 
     vec3 light2 =
-        (diff2 * uLightPower2 * att2) *
-        uLightColor2;
+        (diff2 * uLightColor2.w * att2) *
+        uLightColor2.rgb;
 
     vec3 totalLight = light1 + light2;
 
     base.rgb *= totalLight;
-    base.rgb += (uLightColor + uLightColor2) * uEmissive * 0.15;
+    base.rgb += (uLightColor.rgb + uLightColor2.rgb) * emissive * 0.15;
 
     FragColor = base;
 }
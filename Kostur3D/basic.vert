@@ -5,25 +5,55 @@ layout (location = 1) in vec4 aColor;
 layout (location = 2) in vec2 aUV;
 layout (location = 3) in vec3 aNormal;
 
-uniform mat4 uM;
-uniform mat4 uV;
-uniform mat4 uP;
+// Znakovi displeja (instancirano): centar + sloj, velicina, boja
+layout (location = 4) in vec4 aGlyph;
+layout (location = 5) in vec2 aGlyphSize;
+layout (location = 6) in vec4 aGlyphTint;
+
+// Jednom po frejmu (FrameUniforms u Renderer.h)
+layout (std140) uniform Frame {
+    mat4 uV;
+    mat4 uP;
+    vec4 uLightPos;
+    vec4 uLightColor;     // w = snaga
+    vec4 uLightPos2;
+    vec4 uLightColor2;    // w = snaga
+    vec4 uAmbient;        // x
+};
+
+// Po pozivu, iz prstena (DrawUniforms u Renderer.h)
+layout (std140) uniform Draw {
+    mat4 uM;
+    vec4 uTint;
+    vec4 uPosScale;       // dekvantizacija pozicije za Packed format (za Float je scale 1, offset 0)
+    vec4 uPosOffset;
+    ivec4 uFlags;         // x useTex, y unlit, z mod: 0 mesh, 1 znakovi, 3 ekran
+    vec4 uParams;         // x emissive
+};
 
 out vec4 vColor;
 out vec2 vUV;
 out vec3 vN;
 out vec3 vWorldPos; 
+flat out float vLayer;
 
 void main()
 {
     vColor = aColor;
     vUV = aUV;
 
-    vec4 world = uM * vec4(aPos, 1.0);   
+    vec3 pos = aPos * uPosScale.xyz + uPosOffset.xyz;
+    vLayer = 0.0;
+    if (uFlags.z == 1) {
+        pos = aGlyph.xyz + vec3(aPos.xy * aGlyphSize, 0.0);
+        vColor = aColor * aGlyphTint;
+        vLayer = aGlyph.w;
+    }
+    vec4 world = uM * vec4(pos, 1.0);   
     vWorldPos = world.xyz;              
 
     mat3 Nmat = mat3(transpose(inverse(uM)));
     vN = normalize(Nmat * aNormal);
 
-    gl_Position = uP * uV * world;   
+    gl_Position = (uFlags.z == 3) ? world : uP * uV * world;
 }
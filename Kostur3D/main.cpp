@@ -3,6 +3,7 @@
 #include <thread>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -13,7 +14,17 @@
 #include "Header/Camera.h"
 #include "Header/MeshBuilders.h"
 #include "Header/Renderer.h"
-#include "Header/tiny_obj_loader.h"
+#include "Header/GLState.h"
+#include "Header/ObjLoader.h"
+#include "Header/AssetArchive.h"
+#include "Header/AssetLoader.h"
+#include "Header/TextureRegistry.h"
+#include "Header/UploadRing.h"
+#include "Header/GlyphArray.h"
+#include "Header/MeshOptimizer.h"
+#include "Header/MeshSimplifier.h"
+#include "Header/StaticBatch.h"
+#include "Header/Portals.h"
 
 
 static void framebuffer_size_callback(GLFWwindow *, int width, int height)
@@ -54,155 +65,6 @@ static float FacingDotToAC(const glm::vec3 &camPos, const glm::vec3 &camFront, c
     return glm::dot(f, toAc);
 }
 
-static bool LoadObjToMeshGL(const char* objPath, Renderer& R, MeshGL& outMesh, const glm::vec4& color)
-{
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    std::string baseDir = std::string(objPath);
-    auto slash = baseDir.find_last_of("/\\");
-    baseDir = (slash == std::string::npos) ? "" : baseDir.substr(0, slash + 1);
-
-    bool ok = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath, baseDir.c_str(), true);
-    if (!ok) return false;
-
-    std::vector<float> data;
-    data.reserve(12 * 200000);
-
-    auto pushV = [&](float px,float py,float pz, float u,float v, float nx,float ny,float nz)
-    {
-        data.push_back(px); data.push_back(py); data.push_back(pz);
-        data.push_back(color.r); data.push_back(color.g); data.push_back(color.b); data.push_back(color.a);
-        data.push_back(u); data.push_back(v);
-        data.push_back(nx); data.push_back(ny); data.push_back(nz);
-    };
-
-    for (const auto& s : shapes)
-    {
-        for (const auto& idx : s.mesh.indices)
-        {
-            float px = attrib.vertices[3 * idx.vertex_index + 0];
-            float py = attrib.vertices[3 * idx.vertex_index + 1];
-            float pz = attrib.vertices[3 * idx.vertex_index + 2];
-
-            float nx = 0, ny = 1, nz = 0;
-            if (idx.normal_index >= 0)
-            {
-                nx = attrib.normals[3 * idx.normal_index + 0];
-                ny = attrib.normals[3 * idx.normal_index + 1];
-                nz = attrib.normals[3 * idx.normal_index + 2];
-            }
-
-            float u = 0, v = 0;
-            if (idx.texcoord_index >= 0)
-            {
-                u = attrib.texcoords[2 * idx.texcoord_index + 0];
-                v = attrib.texcoords[2 * idx.texcoord_index + 1];
-            }
-
-            pushV(px, py, pz, u, v, nx, ny, nz);
-        }
-    }
-
-    R.CreateFromFloats(outMesh, data, false);
-    return true;
-}
-
-static bool LoadObjToFourMeshesByMtlName(
-    const char* objPath, Renderer& R,
-    MeshGL& out0, MeshGL& out1, MeshGL& out2, MeshGL& out3,
-    const glm::vec4& color,
-    const std::string& n0="mat0",
-    const std::string& n1="mat1",
-    const std::string& n2="mat2",
-    const std::string& n3="mat3")
-{
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    std::string baseDir = std::string(objPath);
-    auto slash = baseDir.find_last_of("/\\");
-    baseDir = (slash == std::string::npos) ? "" : baseDir.substr(0, slash + 1);
-
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath, baseDir.c_str(), true))
-        return false;
-
-    int id0=-1,id1=-1,id2=-1,id3=-1;
-    for(int i=0;i<(int)materials.size();i++){
-        if(materials[i].name==n0) id0=i;
-        if(materials[i].name==n1) id1=i;
-        if(materials[i].name==n2) id2=i;
-        if(materials[i].name==n3) id3=i;
-    }
-
-    std::vector<float> d0,d1,d2,d3;
-    d0.reserve(12*50000); d1.reserve(12*50000);
-    d2.reserve(12*50000); d3.reserve(12*50000);
-
-    auto pushV = [&](std::vector<float>& data, float px,float py,float pz, float u,float v, float nx,float ny,float nz)
-    {
-        data.push_back(px); data.push_back(py); data.push_back(pz);
-        data.push_back(color.r); data.push_back(color.g); data.push_back(color.b); data.push_back(color.a);
-        data.push_back(u); data.push_back(v);
-        data.push_back(nx); data.push_back(ny); data.push_back(nz);
-    };
-
-    for (const auto& s : shapes)
-    {
-        size_t index_offset = 0;
-        for (size_t f = 0; f < s.mesh.num_face_vertices.size(); f++)
-        {
-            int fv = s.mesh.num_face_vertices[f];
-            int faceMat = (f < s.mesh.material_ids.size()) ? s.mesh.material_ids[f] : -1;
-
-            std::vector<float>* target = nullptr;
-            if      (faceMat == id0) target = &d0;
-            else if (faceMat == id1) target = &d1;
-            else if (faceMat == id2) target = &d2;
-            else if (faceMat == id3) target = &d3;
-            else { index_offset += fv; continue; }
-
-            for (int vtx = 0; vtx < fv; vtx++)
-            {
-                tinyobj::index_t idx = s.mesh.indices[index_offset + vtx];
-
-                float px = attrib.vertices[3 * idx.vertex_index + 0];
-                float py = attrib.vertices[3 * idx.vertex_index + 1];
-                float pz = attrib.vertices[3 * idx.vertex_index + 2];
-
-                float nx=0, ny=1, nz=0;
-                if (idx.normal_index >= 0){
-                    nx = attrib.normals[3 * idx.normal_index + 0];
-                    ny = attrib.normals[3 * idx.normal_index + 1];
-                    nz = attrib.normals[3 * idx.normal_index + 2];
-                }
-
-                float u=0, v=0;
-                if (idx.texcoord_index >= 0){
-                    u = attrib.texcoords[2 * idx.texcoord_index + 0];
-                    v = attrib.texcoords[2 * idx.texcoord_index + 1];
-                }
-
-                pushV(*target, px,py,pz, u,v, nx,ny,nz);
-            }
-            index_offset += fv;
-        }
-    }
-
-    bool ok=false;
-    if(!d0.empty()){ R.CreateFromFloats(out0, d0, false); ok=true; }
-    if(!d1.empty()){ R.CreateFromFloats(out1, d1, false); ok=true; }
-    if(!d2.empty()){ R.CreateFromFloats(out2, d2, false); ok=true; }
-    if(!d3.empty()){ R.CreateFromFloats(out3, d3, false); ok=true; }
-    return ok;
-}
-
-
-
 int main()
 {
     if (!glfwInit())
@@ -234,72 +96,334 @@ int main()
         return 3;
     }
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_CULL_FACE);
+    gGLState.Enable(GL_DEPTH_TEST, true);
+    gGLState.Enable(GL_BLEND, true);
+    gGLState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gGLState.Enable(GL_CULL_FACE, true);
+    gGLState.DepthMask(true);
+    gGLState.Enable(GL_POLYGON_OFFSET_FILL, false);
+
+    // Ako postoji arhiva (cmake --build . --target pack_assets), sve logicke putanje se citaju iz nje
+    gArchive.Open("assets.kpak");
 
     unsigned int shader = createShader("basic.vert", "basic.frag");
     Renderer R;
     R.Init(shader, "res/overlay.png");
+    // Radne niti pisu teksture direktno u PBO slotove
+    gUploadRing.Init();
+    // Ispecene teksture scene su oko 2.5 MB, pa podrazumevano nema budzeta i sve ostaje u punoj rezoluciji.
+    // KOSTUR_TEX_BUDGET_MB zadaje budzet; preko njega nevidljivi i udaljeni objekti zadrzavaju samo nize mipove
+    if (const char* budgetMb = std::getenv("KOSTUR_TEX_BUDGET_MB"))
+        gTextures.SetBudget((size_t)std::strtoul(budgetMb, nullptr, 10) << 20);
 
     std::vector<float> basinMesh, waterMesh, sphereMesh;
     BuildCylinder(basinMesh, 0.30f, gBasinHeight, 64, glm::vec4(0.831f, 0.722f, 0.702f, 1.0f), true);
-    R.CreateFromFloats(R.basin, basinMesh, false);
     BuildCylinder(waterMesh, 0.30f, gBasinHeight, 64, glm::vec4(0.30f, 0.60f, 1.00f, 0.55f), true);
-    R.CreateFromFloats(R.water, waterMesh, false);
     BuildSphere(sphereMesh, 1.0f, 16, 12, glm::vec4(0.35f, 0.70f, 1.0f, 0.55f));
-    R.CreateFromFloats(R.dropletSphere, sphereMesh, false);
+
+    auto createOptimized = [&](MeshGL& m, const std::vector<float>& floats, const char* name)
+    {
+        MeshData md;
+        MeshDataFromFloats(floats, md);
+        OptimizeMesh(md, name);
+        BuildMeshLods(md, name);
+        R.CreateIndexed(m, md.vertices.data(), md.vertices.size(), md.indices.data(), md.indices.size());
+        for (const MeshLod& l : md.lods)
+            m.lods.push_back({ (GLsizei)l.first, (GLsizei)l.count, l.error });
+        if (!m.lods.empty()) m.indexCount = m.lods[0].count;
+    };
+    createOptimized(R.basin, basinMesh, "basin");
+    createOptimized(R.water, waterMesh, "water");
+    createOptimized(R.dropletSphere, sphereMesh, "dropletSphere");
 
     gLedPos = gAcPos + glm::vec3(0.38f, -0.075f, 0.13f);
     glClearColor(0.671f, 0.851f, 0.89f, 1.0f);
 
-    unsigned int overlayTex = loadImageToTexture("res/overlay.png");
-    unsigned int wallTex = loadImageToTexture("res/wall.png");
-    unsigned int wall2Tex = loadImageToTexture("res/wall2.png");
-    unsigned int floorTex = loadImageToTexture("res/floor.png");
-    unsigned int bathroomFloorTex = loadImageToTexture("res/bathroom-floor.png");
-    unsigned int bathroomWallTex = loadImageToTexture("res/bathroom-wall.png");
-
-    unsigned int whiteTex;
-    unsigned char px[4] = {255, 255, 255, 255};
-    glGenTextures(1, &whiteTex);
-    glBindTexture(GL_TEXTURE_2D, whiteTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, px);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    unsigned int laptopTopTex = loadImageToTexture("res/laptop-top.png");
-    unsigned int laptopBottomTex = loadImageToTexture("res/laptop-bottom.png");
-    unsigned int iphoneTex = loadImageToTexture("res/iphone.png");
-
-    unsigned int lampTex = loadImageToTexture("res/lamp.png");
-    unsigned int digitTex[10];
-    for (int i = 0; i < 10; i++)
-    {
-        digitTex[i] = loadImageToTexture(("res/digits/" + std::to_string(i) + ".png").c_str());
-    }
-    unsigned int fireTex = loadImageToTexture("res/fire.png");
-    unsigned int snowTex = loadImageToTexture("res/snow.png");
-    unsigned int okTex = loadImageToTexture("res/check.png");
-    unsigned int minusTex = loadImageToTexture("res/minus.png");
-    unsigned int toiletTex = loadImageToTexture("res/toilet/Toilet.jpg");
-    unsigned int cupboardTex = loadImageToTexture("res/cupboard.png");
-    unsigned int remoteTex14 = loadImageToTexture("res/remote/blinn14SG_baseColor.png");
-    unsigned int remoteTex8  = loadImageToTexture("res/remote/blinn8SG_baseColor.png");
+    // Registar deli teksture po putanji; overlay.png je vec ucitan u R.Init
+    GLuint whiteTex = gTextures.White();
+
+    AssetLoader assets;
+
+    TextureHandle overlayTex = assets.RequestTexture("res/overlay.png");
+    TextureHandle wallTex = assets.RequestTexture("res/wall.png");
+    TextureHandle wall2Tex = assets.RequestTexture("res/wall2.png");
+    TextureHandle floorTex = assets.RequestTexture("res/floor.png");
+    TextureHandle bathroomFloorTex = assets.RequestTexture("res/bathroom-floor.png");
+    TextureHandle bathroomWallTex = assets.RequestTexture("res/bathroom-wall.png");
+
+    TextureHandle laptopTopTex = assets.RequestTexture("res/laptop-top.png");
+    TextureHandle laptopBottomTex = assets.RequestTexture("res/laptop-bottom.png");
+    TextureHandle iphoneTex = assets.RequestTexture("res/iphone.png");
+
+    TextureHandle lampTex = assets.RequestTexture("res/lamp.png");
+
+    // Cifre, minus i ikonice displeja u jednom nizu tekstura (redosled = GlyphLayer)
+    const std::vector<std::string> glyphPaths = {
+        "res/digits/0.png", "res/digits/1.png", "res/digits/2.png", "res/digits/3.png", "res/digits/4.png",
+        "res/digits/5.png", "res/digits/6.png", "res/digits/7.png", "res/digits/8.png", "res/digits/9.png",
+        "res/minus.png", "res/fire.png", "res/snow.png", "res/check.png"
+    };
+    GlyphArray glyphs;
+    glyphs.Init(assets.RequestTextureArray("res/glyphs", glyphPaths, 256));
+
+    TextureHandle toiletTex = assets.RequestTexture("res/toilet/Toilet.jpg");
+    TextureHandle cupboardTex = assets.RequestTexture("res/cupboard.png");
 
     MeshGL toiletMesh;
     MeshGL floorMatMesh;
     MeshGL sinkMesh;
-    MeshGL remoteMat0Mesh, remoteMat1Mesh, remoteMat2Mesh, remoteMat3Mesh;
-    bool toiletOk = LoadObjToMeshGL("res/toilet/10778_Toilet_V2.obj", R, toiletMesh, glm::vec4(1,1,1,1));    
-    bool floorMatOk = LoadObjToMeshGL("res/mat/mat.obj", R, floorMatMesh, glm::vec4(0.467f, 0.553f, 0.6f, 1.0f));
-    bool sinkOk = LoadObjToMeshGL("res/sink/lavandino.obj", R, sinkMesh, glm::vec4(0.95f, 0.95f, 0.98f, 1.0f));
-    bool remoteOk = LoadObjToFourMeshesByMtlName("res/remote/ac_remote__free.obj", R, remoteMat0Mesh, remoteMat1Mesh, remoteMat2Mesh, remoteMat3Mesh, glm::vec4(1,1,1,1), "mat0","mat1","mat2","mat3");
+    MeshGL remoteMesh;
+    bool toiletOk = false, floorMatOk = false, sinkOk = false, remoteOk = false;
+    // Najskuplji modeli; iza zida se ne crtaju (O ukljucuje/iskljucuje)
+    int toiletQuery = R.CreateOcclusionQuery("wc solja");
+    int sinkQuery = R.CreateOcclusionQuery("lavabo");
+    assets.RequestMesh("res/toilet/10778_Toilet_V2.obj", glm::vec4(1,1,1,1), &toiletMesh, &toiletOk, VertexFormat::Packed);
+    assets.RequestMesh("res/mat/mat.obj", glm::vec4(0.467f, 0.553f, 0.6f, 1.0f), &floorMatMesh, &floorMatOk, VertexFormat::Packed);
+    assets.RequestMesh("res/sink/lavandino.obj", glm::vec4(0.95f, 0.95f, 0.98f, 1.0f), &sinkMesh, &sinkOk, VertexFormat::Packed);
+    assets.RequestSubMeshes("res/remote/ac_remote__free.obj", glm::vec4(1,1,1,1), &remoteMesh, &remoteOk, {"mat0","mat1","mat2","mat3"}, VertexFormat::Packed);
+
+    assets.Start();
+
+    //------------------------------------------------Staticna geometrija------------------------------------------------
+    // Zidovi, podovi, namestaj i stvari na stolovima se ne pomeraju: jednom se transformisu u svet
+    // i grupisu po teksturi, pa se u petlji crtaju sa po jednim pozivom za svaku grupu
+    StaticBatch statics;
+
+    //------------------------------------------------Sobe i portali------------------------------------------------
+    // Soba sa klimom i kupatilo iza zida 2. Zidovi idu do y = 1.45, a iznad, levo i ispred sobe
+    // je otvoreno, pa je sve ostalo soba "spolja" sa portalima na otvorenim stranama
+    PortalGraph portals;
+    const float roomLo = -1.2f, roomHi = 1.45f;
+    int mainRoom = portals.AddRoom("soba", glm::vec3(-2.09f, roomLo, -3.12f), glm::vec3(1.69f, roomHi, 0.88f));
+    int bathRoom = portals.AddRoom("kupatilo", glm::vec3(0.09f, roomLo, 0.88f), glm::vec3(1.69f, roomHi, 3.08f));
+    int outside = portals.AddRoom("spolja", glm::vec3(-1e4f), glm::vec3(1e4f));
+
+    // Otvor izmedju sobe i kupatila
+    portals.AddPortal(mainRoom, bathRoom, glm::vec3(0.09f, roomLo, 0.88f), glm::vec3(1.69f, roomHi, 0.88f));
+    // Soba: levo, ispred (pored kupatila) i gore
+    portals.AddPortal(mainRoom, outside, glm::vec3(-2.09f, roomLo, -3.12f), glm::vec3(-2.09f, roomHi, 0.88f));
+    portals.AddPortal(mainRoom, outside, glm::vec3(-2.09f, roomLo, 0.88f), glm::vec3(0.09f, roomHi, 0.88f));
+    portals.AddPortal(mainRoom, outside, glm::vec3(-2.09f, roomHi, -3.12f), glm::vec3(1.69f, roomHi, 0.88f));
+    // Kupatilo: levo i gore
+    portals.AddPortal(bathRoom, outside, glm::vec3(0.09f, roomLo, 0.88f), glm::vec3(0.09f, roomHi, 3.08f));
+    portals.AddPortal(bathRoom, outside, glm::vec3(0.09f, roomHi, 0.88f), glm::vec3(1.69f, roomHi, 3.08f));
+
+    auto DrawBox = [&](const glm::vec3 &pos, const glm::vec3 &size, const glm::vec4 &col, float rotYdeg = 0.0f)
+    {
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
+        if (rotYdeg != 0.0f)
+            M = glm::rotate(M, glm::radians(rotYdeg), glm::vec3(0, 1, 0));
+        M = glm::scale(M, size);
+        statics.AddCube(M, col);
+    };
+
+    //Zid 1
+    glm::vec3 wallSize(19.0f, 13.0f, 0.1f);
+    float acHalfDepth = 1.2f * 0.5f;
+    float wallGap = 0.0f;
+    glm::vec3 wallPos = gAcPos + glm::vec3(0.0f, -0.85f, -0.12f);
+
+    glm::mat4 Mwall = glm::translate(glm::mat4(1.0f), wallPos);
+    Mwall = glm::rotate(Mwall, glm::radians(180.0f), glm::vec3(0, 0, 1));
+    Mwall = glm::scale(Mwall, wallSize);
+
+    statics.room = mainRoom;
+    statics.AddTexturedCube(Mwall, wallTex, glm::vec4(1.0f), false);
+
+    // Zid kupatila
+    glm::vec3 wall2Size(13.0f, 8.0f, 0.1f);
+    glm::vec3 wall2Pos(0.89f, 0.15f, 3.08f);
+
+    glm::mat4 Mwall2 = glm::translate(glm::mat4(1.0f), wall2Pos);
+    Mwall2 = glm::rotate(Mwall2, glm::radians(270.0f), glm::vec3(0, 0, 1));
+    Mwall2 = glm::scale(Mwall2, wall2Size);
+
+    // Zid 2
+    glm::vec3 wallThin(0.1f, 13.0f, 20.0f); 
+
+    {
+        glm::vec3 pos = glm::vec3(1.7f, 0.15f, -1.13f);
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
+        M = glm::scale(M, wallThin);
+        statics.AddTexturedCube(M, wall2Tex, glm::vec4(1.0f), false);
+        statics.room = bathRoom;
+        statics.AddTexturedCube(Mwall2, bathroomWallTex, glm::vec4(1.0f), false);
+    }
+
+    // Zid kupatila 2
+    {
+        glm::vec3 backWallSize(0.1f, 13.0f, 11.0f);  
+        glm::vec3 pos = glm::vec3(1.7f, 0.15f, 1.97f);
+
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
+        M = glm::rotate(M, glm::radians(180.0f), glm::vec3(1, 0, 0));
+        M = glm::scale(M, backWallSize);
+
+        statics.AddTexturedCube(M, bathroomWallTex, glm::vec4(1.0f), false);
+    }
+
+    //Pod
+    glm::vec3 floorSize(18.9f, 0.1f, 20.0f);
+    float floorY = (gBasinOriginalPos.y - (gBasinHeight * 0.5f)) - (floorSize.y * 0.5f) - 0.02f;
+    glm::vec3 floorPos(-0.2f, floorY, -1.12f);
+
+    glm::mat4 Mfloor = glm::translate(glm::mat4(1.0f), floorPos);
+    Mfloor = glm::rotate(Mfloor, glm::radians(180.0f), glm::vec3(0, 0, 1));
+    Mfloor = glm::scale(Mfloor, floorSize);
+
+    statics.room = mainRoom;
+    statics.AddTexturedCube(Mfloor, floorTex);
+
+    // Pod kupatila
+    glm::vec3 floor2Size(8.0f, 0.1f, 11.0f);
+    glm::vec3 floor2Pos(0.89f, floorY, 1.98f);
+
+    glm::mat4 Mfloor2 = glm::translate(glm::mat4(1.0f), floor2Pos);
+    Mfloor2 = glm::rotate(Mfloor2, glm::radians(180.0f), glm::vec3(0, 0, 1));
+    Mfloor2 = glm::scale(Mfloor2, floor2Size);
+
+    statics.room = bathRoom;
+    statics.AddTexturedCube(Mfloor2, bathroomFloorTex);
+
+
+    // Lavabo - Donji Deo
+    {
+    
+        glm::vec3 basePos = wall2Pos + glm::vec3(-0.35f, -1.01f, -0.08f);
+        glm::vec3 baseSize = glm::vec3(2.45f, 2.69f, 0.78f);
+
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), basePos);
+        M = glm::scale(M, baseSize);
+
+        glm::vec4 bodyCol(0.95f, 0.95f, 0.95f, 1.0f);
+
+        statics.AddTexturedCubeFace(M, cupboardTex, bodyCol, glm::vec4(1,1,1,1), CubeFace::Back, 0.004f, false);
+        
+    }
+
+    statics.room = mainRoom;
+
+    //Prvi sto
+    glm::vec3 deskTopPos = glm::vec3(-1.305f, -0.60f, -0.65f);
+    glm::vec3 deskTopSize = glm::vec3(5.2f, 0.12f, 4.1f);
+    DrawBox(deskTopPos, deskTopSize, glm::vec4(0.467f, 0.553f, 0.6f, 1.0f));
+
+    glm::vec3 deskLegSize = glm::vec3(0.12f, 2.35f, 0.12f);
+
+    glm::vec3 deskLeg1Pos = glm::vec3(-1.80f, -0.85f, -0.3f);
+    glm::vec3 deskLeg2Pos = glm::vec3(-0.80f, -0.85f, -0.3f);
+    glm::vec3 deskLeg3Pos = glm::vec3(-1.80f, -0.85f, -1.0f);
+    glm::vec3 deskLeg4Pos = glm::vec3(-0.80f, -0.85f, -1.0f);
+
+    DrawBox(deskLeg1Pos, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
+    DrawBox(deskLeg2Pos, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
+    DrawBox(deskLeg3Pos, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
+    DrawBox(deskLeg4Pos, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
+
+    //Prva stolica
+    glm::vec3 chairSeatPos = glm::vec3(-1.296f, -0.82f, -1.03f);
+    glm::vec3 chairSeatSize = glm::vec3(1.65f, 0.20f, 1.9f);
+    DrawBox(chairSeatPos, chairSeatSize, glm::vec4(0.25f, 0.25f, 0.28f, 1));
+
+    glm::vec3 chairLegSize = glm::vec3(0.11f, 1.55f, 0.11f);
+
+    glm::vec3 chairLeg1Pos = glm::vec3(-1.40f, -1.0f, -0.9f);
+    glm::vec3 chairLeg2Pos = glm::vec3(-1.20f, -1.0f, -0.9f);
+    glm::vec3 chairLeg3Pos = glm::vec3(-1.40f, -1.0f, -1.17f);
+    glm::vec3 chairLeg4Pos = glm::vec3(-1.20f, -1.0f, -1.17f);
+
+    DrawBox(chairLeg1Pos, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
+    DrawBox(chairLeg2Pos, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
+    DrawBox(chairLeg3Pos, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
+    DrawBox(chairLeg4Pos, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
+
+    glm::vec3 chairBackPos = glm::vec3(-1.296f, -0.65f, -1.22f);
+    glm::vec3 chairBackSize = glm::vec3(1.65f, 1.9f, 0.25f);
+    DrawBox(chairBackPos, chairBackSize, glm::vec4(0.22f, 0.22f, 0.25f, 1));
+
+    
+    //Drugi sto
+    float dx = 2.2f;
+    glm::vec3 shift(dx, 0.0f, 0.0f);
+
+    DrawBox(deskTopPos + shift, deskTopSize, glm::vec4(0.467f, 0.553f, 0.6f, 1.0f));
+
+    DrawBox(deskLeg1Pos + shift, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
+    DrawBox(deskLeg2Pos + shift, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
+    DrawBox(deskLeg3Pos + shift, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
+    DrawBox(deskLeg4Pos + shift, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
+
+    //Druga stolica
+    DrawBox(chairSeatPos + shift, chairSeatSize, glm::vec4(0.25f, 0.25f, 0.28f, 1));
+    DrawBox(chairBackPos + shift, chairBackSize, glm::vec4(0.22f, 0.22f, 0.25f, 1));
+
+    DrawBox(chairLeg1Pos + shift, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
+    DrawBox(chairLeg2Pos + shift, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
+    DrawBox(chairLeg3Pos + shift, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
+    DrawBox(chairLeg4Pos + shift, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
 
+    
+
+    //------------------------------------------------Stvari na stolovima------------------------------------------------
+    
+    //Laptop - ekran
+    {
+        glm::vec3 pos = glm::vec3(-1.3f, -0.441f, -0.579f);
+        glm::vec3 size = glm::vec3(0.04f, 1.25f, 1.05f);
+
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
+        M = glm::rotate(M, glm::radians(90.0f), glm::vec3(0, 1, 0));
+        M = glm::rotate(M, glm::radians(90.0f), glm::vec3(1, 0, 0));
+        M = glm::scale(M, size);
+
+        statics.AddTexturedCubeFace(M, laptopTopTex, glm::vec4(0.984f, 0.855f, 0.835f, 1.0f), glm::vec4(1, 1, 1, 1), CubeFace::Right, 0.004f);
+    }
+
+    //Laptop - tastatura
+    {
+        glm::vec3 pos = glm::vec3(-1.3f, -0.55f, -0.68f);
+        glm::vec3 size = glm::vec3(1.05f, 0.04f, 1.25f);
+
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
+        M = glm::rotate(M, glm::radians(90.0f), glm::vec3(0, 1, 0));
+        M = glm::scale(M, size);
+
+        statics.AddTexturedCubeFace(M, laptopBottomTex, glm::vec4(0.984f, 0.855f, 0.835f, 1.0f), glm::vec4(1, 1, 1, 1), CubeFace::Top, 0.004f);
+    }
+
+    //Papir + Ime
+    {
+        glm::vec3 pos = glm::vec3(0.9f, -0.57f, -0.65f);
+        glm::vec3 size = glm::vec3(1.85f, 0.02f, 1.30f);
+
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
+        M = glm::rotate(M, glm::radians(90.0f), glm::vec3(0, 1, 0));
+        M = glm::scale(M, size);
+
+        statics.AddTexturedCubeFace(M, overlayTex, glm::vec4(1, 1, 1, 1), glm::vec4(1, 1, 1, 1), CubeFace::Top, 0.004f);
+    }
+
+    //Telefon
+    {
+        glm::vec3 pos = glm::vec3(0.7f, -0.57f, -0.65f);
+        glm::vec3 size = glm::vec3(0.64f, 0.03f, 0.28f);
+
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
+        M = glm::rotate(M, glm::radians(90.0f), glm::vec3(0, 1, 0));
+        M = glm::scale(M, size);
+
+        statics.AddTexturedCubeFace(M, iphoneTex, glm::vec4(0, 0, 0, 1), glm::vec4(1, 1, 1, 1), CubeFace::Top, 0.003f);
+    }
+
+    statics.Build(R);
+
+    bool texStatsShown = false;
     double lastTime = glfwGetTime();
     bool depthOn = true;
     bool cullOn = true;
     bool prevD = false;
     bool prevC = false;
+    bool prevO = false;
 
     while (!glfwWindowShouldClose(window))
     {
@@ -309,6 +433,17 @@ int main()
         if (dt > 0.05)
             dt = 0.05;
 
+        // Modeli i teksture stizu u pozadini; do tada se crtaju placeholderi
+        assets.Pump(R, 0.004);
+        if (!texStatsShown && assets.Done())
+        {
+            gTextures.PrintStats();
+            gUploadRing.PrintStats();
+            R.PrintStats();
+            portals.PrintStats();
+            texStatsShown = true;
+        }
+
         // Kontrole kretanja (Strelice)
         float speed = 2.0f * (float)dt;
         float fw = 0.0f, rt = 0.0f;
@@ -339,13 +474,18 @@ int main()
         if (cNow && !prevC) cullOn = !cullOn;
         prevC = cNow;
 
-        depthOn ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
-        cullOn  ? glEnable(GL_CULL_FACE)  : glDisable(GL_CULL_FACE);
+        // Upiti zaklonjenosti (O)
+        bool oNow = glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS;
+        if (oNow && !prevO) R.occlusionOn = !R.occlusionOn;
+        prevO = oNow;
+
+        // Stanje se snima uz svaki poziv i primenjuje tek u R.Submit
+        R.state.depthTest = depthOn;
+        R.state.cull = cullOn;
 
         auto SetCullLocal = [&](bool wantCullForThisDraw)
         {
-            if (!cullOn) { glDisable(GL_CULL_FACE); return; } 
-            wantCullForThisDraw ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+            R.state.cull = cullOn && wantCullForThisDraw;
         };
 
 
@@ -445,121 +585,42 @@ int main()
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         int fbW, fbH;
         glfwGetFramebufferSize(window, &fbW, &fbH);
-        R.SetCommonUniforms(gCamera.View(), gCamera.Projection((float)fbW / (float)fbH));
+        R.SetCommonUniforms(gCamera.View(), gCamera.Projection((float)fbW / (float)fbH), (float)fbH);
+        portals.Update(gCamera.pos, R.frame.P * R.frame.V);
+        R.visibleRooms = portals.Visible();
 
         glm::vec3 lightPos = glm::vec3(-0.5f, 4.5f, -1.0f);
         glm::vec3 lightColor = glm::vec3(0.98f, 0.98f, 1.0f); 
         float lightPower = 0.9f;  
         float ambient = 0.75f;
 
-        glUniform3fv(glGetUniformLocation(shader, "uLightPos"), 1, glm::value_ptr(lightPos));
-        glUniform3fv(glGetUniformLocation(shader, "uLightColor"), 1, glm::value_ptr(lightColor));
-        glUniform1f(glGetUniformLocation(shader, "uLightPower"), lightPower);
-        glUniform1f(glGetUniformLocation(shader, "uAmbient"), ambient);
-        glUniform1f(glGetUniformLocation(shader, "uEmissive"), 0.0f);
+        R.SetLight(0, lightPos, lightColor, lightPower);
+        R.SetAmbient(ambient);
 
         glm::mat4 Mlight = glm::scale(glm::translate(glm::mat4(1.0f), lightPos), glm::vec3(0.12f));
-        glUniform1i(glGetUniformLocation(shader, "uUnlit"), 1);
-        glUniform1f(glGetUniformLocation(shader, "uEmissive"), 1.0f);
+        R.state.unlit = true;
+        R.state.emissive = 1.0f;
         R.DrawMeshTriangles(R.dropletSphere, Mlight, glm::vec4(lightColor, 1.0f), false);
 
-        glUniform1f(glGetUniformLocation(shader, "uEmissive"), 0.0f);
-        glUniform1i(glGetUniformLocation(shader, "uUnlit"), 0);
+        R.state.emissive = 0.0f;
+        R.state.unlit = false;
 
         glm::vec3 lightPos2   = gLedPos;                      
         glm::vec3 lightColor2 = glm::vec3(1.0f, 0.12f, 0.08f);  
         float lightPower2     = gAcOn ? 0.05f : 0.0f;         
 
-        glUniform3fv(glGetUniformLocation(shader, "uLightPos2"), 1, glm::value_ptr(lightPos2));
-        glUniform3fv(glGetUniformLocation(shader, "uLightColor2"), 1, glm::value_ptr(lightColor2));
-        glUniform1f (glGetUniformLocation(shader, "uLightPower2"), lightPower2);
+        R.SetLight(1, lightPos2, lightColor2, lightPower2);
 
 
 
-        auto DrawBox = [&](const glm::vec3 &pos, const glm::vec3 &size, const glm::vec4 &col, float rotYdeg = 0.0f)
-        {
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
-            if (rotYdeg != 0.0f)
-                M = glm::rotate(M, glm::radians(rotYdeg), glm::vec3(0, 1, 0));
-            M = glm::scale(M, size);
-            R.DrawCube(M, col, false);
-        };
-
         //------------------------------------------------Renderovanje------------------------------------------------
 
-        //Zid 1
-        glm::vec3 wallSize(19.0f, 13.0f, 0.1f);
-        float acHalfDepth = 1.2f * 0.5f;
-        float wallGap = 0.0f;
-        glm::vec3 wallPos = gAcPos + glm::vec3(0.0f, -0.85f, -0.12f);
-
-        glm::mat4 Mwall = glm::translate(glm::mat4(1.0f), wallPos);
-        Mwall = glm::rotate(Mwall, glm::radians(180.0f), glm::vec3(0, 0, 1));
-        Mwall = glm::scale(Mwall, wallSize);
-
-        SetCullLocal(false);
-        R.DrawTexturedCube(Mwall, wallTex);
-        SetCullLocal(true);
-
-        // Zid kupatila
-        glm::vec3 wall2Size(13.0f, 8.0f, 0.1f);
-        glm::vec3 wall2Pos(0.89f, 0.15f, 3.08f);
-  
-        glm::mat4 Mwall2 = glm::translate(glm::mat4(1.0f), wall2Pos);
-        Mwall2 = glm::rotate(Mwall2, glm::radians(270.0f), glm::vec3(0, 0, 1));
-        Mwall2 = glm::scale(Mwall2, wall2Size);
-
-        // Zid 2
-        glm::vec3 wallThin(0.1f, 13.0f, 20.0f); 
-
-        {
-            glm::vec3 pos = glm::vec3(1.7f, 0.15f, -1.13f);
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
-            M = glm::scale(M, wallThin);
-            SetCullLocal(false);
-            R.DrawTexturedCube(M, wall2Tex);
-            R.DrawTexturedCube(Mwall2, bathroomWallTex);
-            SetCullLocal(true);
-        }
-
-        // Zid kupatila 2
-        {
-            glm::vec3 backWallSize(0.1f, 13.0f, 11.0f);  
-            glm::vec3 pos = glm::vec3(1.7f, 0.15f, 1.97f);
-
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
-            M = glm::rotate(M, glm::radians(180.0f), glm::vec3(1, 0, 0));
-            M = glm::scale(M, backWallSize);
-
-            SetCullLocal(false);
-            R.DrawTexturedCube(M, bathroomWallTex);
-            SetCullLocal(true);
-        }
-
-        //Pod
-        glm::vec3 floorSize(18.9f, 0.1f, 20.0f);
-        float floorY = (gBasinOriginalPos.y - (gBasinHeight * 0.5f)) - (floorSize.y * 0.5f) - 0.02f;
-        glm::vec3 floorPos(-0.2f, floorY, -1.12f);
-
-        glm::mat4 Mfloor = glm::translate(glm::mat4(1.0f), floorPos);
-        Mfloor = glm::rotate(Mfloor, glm::radians(180.0f), glm::vec3(0, 0, 1));
-        Mfloor = glm::scale(Mfloor, floorSize);
-
-        R.DrawTexturedCube(Mfloor, floorTex);
-
-        // Pod kupatila
-        glm::vec3 floor2Size(8.0f, 0.1f, 11.0f);
-        glm::vec3 floor2Pos(0.89f, floorY, 1.98f);
-
-        glm::mat4 Mfloor2 = glm::translate(glm::mat4(1.0f), floor2Pos);
-        Mfloor2 = glm::rotate(Mfloor2, glm::radians(180.0f), glm::vec3(0, 0, 1));
-        Mfloor2 = glm::scale(Mfloor2, floor2Size);
-
-        R.DrawTexturedCube(Mfloor2, bathroomFloorTex);
-
+        statics.Draw(R, cullOn);
 
         //------------------------------------------------Nameštaj------------------------------------------------
 
+        R.room = bathRoom;
+
         // WC Solja 
         if (toiletOk)
         {
@@ -570,7 +631,8 @@ int main()
             Mt = glm::rotate(Mt, glm::radians(180.0f), glm::vec3(0,0,1));
             Mt = glm::scale(Mt, glm::vec3(0.02f));
 
-            R.DrawTexturedMesh(toiletMesh, Mt, toiletTex, glm::vec4(1.0f, 0.99f, 0.96f, 1.0f));
+            if (R.OcclusionTest(toiletQuery, toiletMesh, Mt))
+                R.DrawTexturedMesh(toiletMesh, Mt, gTextures.Get(toiletTex), glm::vec4(1.0f, 0.99f, 0.96f, 1.0f));
 
         }
 
@@ -584,26 +646,12 @@ int main()
             Ms = glm::rotate(Ms, glm::radians(90.0f), glm::vec3(0, 1, 0));
             Ms = glm::scale(Ms, glm::vec3(0.00035f));
 
-            SetCullLocal(false);
-            R.DrawMeshTriangles(sinkMesh, Ms, glm::vec4(1.0f, 0.99f, 0.96f, 1.0f), false);
-            SetCullLocal(true);
-        }
-
-        // Lavabo - Donji Deo
-        {
-        
-            glm::vec3 basePos = wall2Pos + glm::vec3(-0.35f, -1.01f, -0.08f);
-            glm::vec3 baseSize = glm::vec3(2.45f, 2.69f, 0.78f);
-
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), basePos);
-            M = glm::scale(M, baseSize);
-
-            glm::vec4 bodyCol(0.95f, 0.95f, 0.95f, 1.0f);
-
-            SetCullLocal(false);
-            R.DrawTexturedCubeFace(M, cupboardTex, bodyCol, glm::vec4(1,1,1,1), CubeFace::Back, 0.004f);
-            SetCullLocal(true);
-            
+            if (R.OcclusionTest(sinkQuery, sinkMesh, Ms))
+            {
+                SetCullLocal(false);
+                R.DrawMeshTriangles(sinkMesh, Ms, glm::vec4(1.0f, 0.99f, 0.96f, 1.0f), false);
+                SetCullLocal(true);
+            }
         }
 
         // Otirač
@@ -622,125 +670,16 @@ int main()
             SetCullLocal(true);
         }
 
-        //Prvi sto
-        glm::vec3 deskTopPos = glm::vec3(-1.305f, -0.60f, -0.65f);
-        glm::vec3 deskTopSize = glm::vec3(5.2f, 0.12f, 4.1f);
-        DrawBox(deskTopPos, deskTopSize, glm::vec4(0.467f, 0.553f, 0.6f, 1.0f));
-
-        glm::vec3 deskLegSize = glm::vec3(0.12f, 2.35f, 0.12f);
-
-        glm::vec3 deskLeg1Pos = glm::vec3(-1.80f, -0.85f, -0.3f);
-        glm::vec3 deskLeg2Pos = glm::vec3(-0.80f, -0.85f, -0.3f);
-        glm::vec3 deskLeg3Pos = glm::vec3(-1.80f, -0.85f, -1.0f);
-        glm::vec3 deskLeg4Pos = glm::vec3(-0.80f, -0.85f, -1.0f);
-
-        DrawBox(deskLeg1Pos, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
-        DrawBox(deskLeg2Pos, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
-        DrawBox(deskLeg3Pos, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
-        DrawBox(deskLeg4Pos, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
-
-        //Prva stolica
-        glm::vec3 chairSeatPos = glm::vec3(-1.296f, -0.82f, -1.03f);
-        glm::vec3 chairSeatSize = glm::vec3(1.65f, 0.20f, 1.9f);
-        DrawBox(chairSeatPos, chairSeatSize, glm::vec4(0.25f, 0.25f, 0.28f, 1));
-
-        glm::vec3 chairLegSize = glm::vec3(0.11f, 1.55f, 0.11f);
-
-        glm::vec3 chairLeg1Pos = glm::vec3(-1.40f, -1.0f, -0.9f);
-        glm::vec3 chairLeg2Pos = glm::vec3(-1.20f, -1.0f, -0.9f);
-        glm::vec3 chairLeg3Pos = glm::vec3(-1.40f, -1.0f, -1.17f);
-        glm::vec3 chairLeg4Pos = glm::vec3(-1.20f, -1.0f, -1.17f);
-
-        DrawBox(chairLeg1Pos, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
-        DrawBox(chairLeg2Pos, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
-        DrawBox(chairLeg3Pos, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
-        DrawBox(chairLeg4Pos, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
-
-        glm::vec3 chairBackPos = glm::vec3(-1.296f, -0.65f, -1.22f);
-        glm::vec3 chairBackSize = glm::vec3(1.65f, 1.9f, 0.25f);
-        DrawBox(chairBackPos, chairBackSize, glm::vec4(0.22f, 0.22f, 0.25f, 1));
-
-        
-        //Drugi sto
-        float dx = 2.2f;
-        glm::vec3 shift(dx, 0.0f, 0.0f);
-
-        DrawBox(deskTopPos + shift, deskTopSize, glm::vec4(0.467f, 0.553f, 0.6f, 1.0f));
-
-        DrawBox(deskLeg1Pos + shift, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
-        DrawBox(deskLeg2Pos + shift, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
-        DrawBox(deskLeg3Pos + shift, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
-        DrawBox(deskLeg4Pos + shift, deskLegSize, glm::vec4(0.20f, 0.20f, 0.20f, 1));
-
-        //Druga stolica
-        DrawBox(chairSeatPos + shift, chairSeatSize, glm::vec4(0.25f, 0.25f, 0.28f, 1));
-        DrawBox(chairBackPos + shift, chairBackSize, glm::vec4(0.22f, 0.22f, 0.25f, 1));
-
-        DrawBox(chairLeg1Pos + shift, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
-        DrawBox(chairLeg2Pos + shift, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
-        DrawBox(chairLeg3Pos + shift, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
-        DrawBox(chairLeg4Pos + shift, chairLegSize, glm::vec4(0.12f, 0.12f, 0.12f, 1));
-        
-
-        //------------------------------------------------Stvari na stolovima------------------------------------------------
-        
-        //Laptop - ekran
-        {
-            glm::vec3 pos = glm::vec3(-1.3f, -0.441f, -0.579f);
-            glm::vec3 size = glm::vec3(0.04f, 1.25f, 1.05f);
-
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
-            M = glm::rotate(M, glm::radians(90.0f), glm::vec3(0, 1, 0));
-            M = glm::rotate(M, glm::radians(90.0f), glm::vec3(1, 0, 0));
-            M = glm::scale(M, size);
-
-            R.DrawTexturedCubeFace(M, laptopTopTex, glm::vec4(0.984f, 0.855f, 0.835f, 1.0f), glm::vec4(1, 1, 1, 1), CubeFace::Right, 0.004f);
-        }
-
-        //Laptop - tastatura
-        {
-            glm::vec3 pos = glm::vec3(-1.3f, -0.55f, -0.68f);
-            glm::vec3 size = glm::vec3(1.05f, 0.04f, 1.25f);
-
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
-            M = glm::rotate(M, glm::radians(90.0f), glm::vec3(0, 1, 0));
-            M = glm::scale(M, size);
-
-            R.DrawTexturedCubeFace(M, laptopBottomTex, glm::vec4(0.984f, 0.855f, 0.835f, 1.0f), glm::vec4(1, 1, 1, 1), CubeFace::Top, 0.004f);
-        }
-
-        //Papir + Ime
-        {
-            glm::vec3 pos = glm::vec3(0.9f, -0.57f, -0.65f);
-            glm::vec3 size = glm::vec3(1.85f, 0.02f, 1.30f);
-
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
-            M = glm::rotate(M, glm::radians(90.0f), glm::vec3(0, 1, 0));
-            M = glm::scale(M, size);
-
-            R.DrawTexturedCubeFace(M, overlayTex, glm::vec4(1, 1, 1, 1), glm::vec4(1, 1, 1, 1), CubeFace::Top, 0.004f);
-        }
-
-        //Telefon
-        {
-            glm::vec3 pos = glm::vec3(0.7f, -0.57f, -0.65f);
-            glm::vec3 size = glm::vec3(0.64f, 0.03f, 0.28f);
-
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), pos);
-            M = glm::rotate(M, glm::radians(90.0f), glm::vec3(0, 1, 0));
-            M = glm::scale(M, size);
-
-            R.DrawTexturedCubeFace(M, iphoneTex, glm::vec4(0, 0, 0, 1), glm::vec4(1, 1, 1, 1), CubeFace::Top, 0.003f);
-        }
-
         //------------------------------------------------Glavni deo------------------------------------------------
 
 
+        R.room = mainRoom;
+
         //Klima
-        glUniform1i(glGetUniformLocation(shader, "uUnlit"), 1);
+        R.state.unlit = true;
         glm::mat4 Ma = glm::scale(glm::translate(glm::mat4(1.0f), gAcPos), glm::vec3(4.5f, 1.3f, 1.2f));
         R.DrawCube(Ma, glm::vec4(1.0f, 0.99f, 0.99f, 1.0f), false);
-        glUniform1i(glGetUniformLocation(shader, "uUnlit"), 0);
+        R.state.unlit = false;
 
 
         //Poklopac
@@ -764,9 +703,9 @@ int main()
         glm::vec4 ledOff = glm::vec4(0.18f, 0.18f, 0.18f, 1.0f);
         glm::vec4 ledOn  = glm::vec4(0.95f, 0.12f, 0.08f, 1.0f);
 
-        glUniform1f(glGetUniformLocation(shader, "uEmissive"), gAcOn ? 0.8f : 0.0f);
-        R.DrawTexturedMesh(R.basin, Ml, lampTex, gAcOn ? ledOn : ledOff);
-        glUniform1f(glGetUniformLocation(shader, "uEmissive"), 0.0f);
+        R.state.emissive = gAcOn ? 0.8f : 0.0f;
+        R.DrawTexturedMesh(R.basin, Ml, gTextures.Get(lampTex), gAcOn ? ledOn : ledOff);
+        R.state.emissive = 0.0f;
         SetCullLocal(false);
 
 
@@ -791,7 +730,8 @@ int main()
         DrawScreenQuad(s2, screenScale, whiteTex, panelTint);
         DrawScreenQuad(s3, screenScale, whiteTex, panelTint);
 
-        //Cifre + Minus
+        //Cifre + Minus + Ikonica - skupljaju se u glyphs i crtaju jednim pozivom
+        glyphs.Clear();
         glm::vec4 digitTint = gAcOn ? glm::vec4(0.88f, 1.05f, 1.00f, 1.0f)
                                     : glm::vec4(0.70f, 0.70f, 0.70f, 1.0f);
 
@@ -821,17 +761,17 @@ int main()
 
             if (isNegative)
             {
-                DrawScreenQuad(glm::vec3(cursorX, panelCenter.y, panelCenter.z + zOffset),
-                               minusScale, minusTex, digitTint);
+                glyphs.Add(glm::vec3(cursorX, panelCenter.y, panelCenter.z + zOffset),
+                           glm::vec2(minusScale), GLYPH_MINUS, digitTint);
             }
             cursorX += wM + spacing;
 
-            DrawScreenQuad(glm::vec3(cursorX, panelCenter.y, panelCenter.z + zOffset),
-                           slotScale, digitTex[tens], digitTint);
+            glyphs.Add(glm::vec3(cursorX, panelCenter.y, panelCenter.z + zOffset),
+                       glm::vec2(slotScale), GLYPH_DIGIT0 + tens, digitTint);
             cursorX += wD + spacing;
 
-            DrawScreenQuad(glm::vec3(cursorX, panelCenter.y, panelCenter.z + zOffset),
-                           slotScale, digitTex[ones], digitTint);
+            glyphs.Add(glm::vec3(cursorX, panelCenter.y, panelCenter.z + zOffset),
+                       glm::vec2(slotScale), GLYPH_DIGIT0 + ones, digitTint);
         };
 
         glm::vec3 center1 = s1 + glm::vec3(0.0f, 0.0f, 0.0f);
@@ -843,14 +783,14 @@ int main()
 
 
         //Ikonice
-        GLuint icon = okTex;
+        int icon = GLYPH_OK;
         float iconDiff = desiredTemp - measuredTemp;
         if (std::fabs(iconDiff) < 0.5f)
-            icon = okTex;
+            icon = GLYPH_OK;
         else if (iconDiff > 0.0f)
-            icon = fireTex;
+            icon = GLYPH_FIRE;
         else
-            icon = snowTex;
+            icon = GLYPH_SNOW;
 
         float zFront = 0.002f;
         float zBack = -0.002f;
@@ -859,13 +799,15 @@ int main()
         glm::vec3 iconScale(0.075f, 0.075f, 1.0f);
         glm::vec3 iconPos = glm::vec3(center3.x, center3.y, center3.z + zOffset);
 
-        DrawScreenQuad(iconPos, iconScale, icon, digitTint);
+        glyphs.Add(iconPos, glm::vec2(iconScale), icon, digitTint);
+        R.DrawGlyphs(glyphs, glm::translate(glm::mat4(1.0f), gAcPos));
         SetCullLocal(true);
 
 
-        //Lavor + Voda + Kapljice
+        //Lavor + Voda + Kapljice - nose se iz sobe u sobu
+        R.room = -1;
         SetCullLocal(false);
-        glDepthMask(GL_TRUE);
+        R.state.depthWrite = true;
 
         R.DrawMeshTriangles(
             R.basin,
@@ -883,15 +825,13 @@ int main()
                                    gBasinPos + glm::vec3(0.0f, waterCenterY, 0.0f)),
                     glm::vec3(0.990f, gWaterLevel, 0.990f));
 
-            glDepthMask(GL_FALSE);
-
-            glEnable(GL_POLYGON_OFFSET_FILL);
-            glPolygonOffset(-1.0f, -1.0f);
+            R.state.depthWrite = false;
+            R.state.polygonOffset = true;
 
             R.DrawMeshTriangles(R.water, Mw, glm::vec4(1, 1, 1, 1), true);
 
-            glDisable(GL_POLYGON_OFFSET_FILL);
-            glDepthMask(GL_TRUE);
+            R.state.polygonOffset = false;
+            R.state.depthWrite = true;
         }
 
         SetCullLocal(true);
@@ -902,11 +842,10 @@ int main()
 
         bool holdingBasin = (gBasinState == BasinState::InFrontFull || gBasinState == BasinState::InFrontEmpty);
 
+        // Predmeti u ruci crtaju se posle cele scene
+        R.pass = RenderPass::Overlay;
         if (holdingBasin)
-        {
-            glClear(GL_DEPTH_BUFFER_BIT);
-            glEnable(GL_DEPTH_TEST);
-        }
+            R.ClearDepth();
 
         //Daljinski + Centar
         if (!holdingBasin && remoteOk)
@@ -934,23 +873,21 @@ int main()
             Mr = glm::rotate(Mr, glm::radians(-90.0f), glm::vec3(0,1,0));
             Mr = glm::scale(Mr, glm::vec3(0.1f));
 
-            glDisable(GL_DEPTH_TEST);
+            R.state.depthTest = false;
             SetCullLocal(false);
 
-            R.DrawMeshTriangles(remoteMat0Mesh, Mr, glm::vec4(1,1,1,1), false);
-            R.DrawMeshTriangles(remoteMat1Mesh, Mr, glm::vec4(1,1,1,1), false);
-            R.DrawTexturedMesh(remoteMat2Mesh, Mr, remoteTex14, glm::vec4(1,1,1,1));
-            R.DrawTexturedMesh(remoteMat3Mesh, Mr, remoteTex8,  glm::vec4(1,1,1,1));
+            R.DrawSubMeshes(remoteMesh, Mr, glm::vec4(1,1,1,1));
             R.DrawCenter();
 
             SetCullLocal(true);
-            glEnable(GL_DEPTH_TEST);
+            R.state.depthTest = depthOn;
         }
         else
         {
             R.DrawCenter();
         }
 
+        R.Submit();
 
         glfwSwapBuffers(window);
         glfwPollEvents();
@@ -960,7 +897,19 @@ int main()
             std::this_thread::sleep_for(std::chrono::duration<double>((1.0 / 75.0) - frameTime));
     }
 
+    for (TextureHandle* h : { &overlayTex, &wallTex, &wall2Tex, &floorTex, &bathroomFloorTex, &bathroomWallTex,
+                              &laptopTopTex, &laptopBottomTex, &iphoneTex, &lampTex, &toiletTex, &cupboardTex })
+        gTextures.Release(*h);
+    glyphs.Destroy();
+
+    R.DestroyMesh(toiletMesh);
+    R.DestroyMesh(floorMatMesh);
+    R.DestroyMesh(sinkMesh);
+    R.DestroyMesh(remoteMesh);
+    statics.Destroy(R);
+    gUploadRing.Destroy();
     R.Destroy();
+    gTextures.Clear();
     glDeleteProgram(shader);
     glfwTerminate();
     return 0;